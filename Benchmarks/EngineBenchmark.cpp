@@ -0,0 +1,355 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 19 Oct 2026 4:12:45pm
+    Author:  Qixuan
+
+    Drives the decks and the mixer without an audio device or a window, the
+    same way MainComponent does, and times every block it renders. Each case
+    is a source file, a block size, a speed ratio and a number of decks, and
+    the results are written out as JSON. Idle cases load the decks without
+    starting them, to measure what a stopped engine costs.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+
+#include <iostream>
+#include <vector>
+
+//==============================================================================
+namespace
+{
+    struct Options
+    {
+        Array<File> files;
+        Array<int> blockSizes{ 64, 128, 256, 512, 1024 };
+        Array<double> speeds{ 0.5, 1.0, 1.5, 2.0 };
+        Array<int> deckCounts{ 1, 2, 4, 8 };
+        double sampleRate = 48000.0;
+        double seconds = 10.0;
+        bool synthetic = true;
+        bool idle = true;
+        File output;
+    };
+
+    // Blocks rendered before the timing starts, so the decoders and caches are warm
+    const int warmUpBlocks = 32;
+
+    // Length of the generated test file, long enough that the fastest case does not loop too often
+    const double syntheticSeconds = 60.0;
+
+    // Function to split a comma separated list of numbers
+    template <typename Type>
+    Array<Type> parseList(const String& list)
+    {
+        Array<Type> values;
+        for (auto& token : StringArray::fromTokens(list, ",", "")) {
+            if (token.trim().isNotEmpty()) {
+                values.add((Type) token.trim().getDoubleValue());
+            }
+        }
+        return values;
+    }
+
+    // Function to write a stereo sweep with some noise, which decodes and resamples like real music
+    File writeSyntheticFile(const File& folder)
+    {
+        const double fileRate = 44100.0;
+        File file = folder.getChildFile("synthetic.wav");
+        file.deleteFile();
+
+        WavAudioFormat wav;
+        std::unique_ptr<FileOutputStream> stream(file.createOutputStream());
+        if (stream == nullptr) {
+            return {};
+        }
+
+        std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(stream.get(), fileRate, 2, 16, {}, 0));
+        if (writer == nullptr) {
+            return {};
+        }
+        stream.release();
+
+        Random random(1234);
+        AudioBuffer<float> chunk(2, 4096);
+        const int64 total = (int64) (syntheticSeconds * fileRate);
+        double phase = 0;
+
+        for (int64 written = 0; written < total; written += chunk.getNumSamples())
+        {
+            const int numSamples = (int) jmin((int64) chunk.getNumSamples(), total - written);
+            for (int i = 0; i < numSamples; ++i) {
+                // A sweep from 50Hz to 5kHz over the whole file
+                const double t = (double) (written + i) / (double) total;
+                phase += MathConstants<double>::twoPi * (50.0 * std::pow(100.0, t)) / fileRate;
+                const float tone = 0.5f * (float) std::sin(phase);
+                chunk.setSample(0, i, tone + 0.05f * (random.nextFloat() - 0.5f));
+                chunk.setSample(1, i, tone + 0.05f * (random.nextFloat() - 0.5f));
+            }
+            writer->writeFromAudioSampleBuffer(chunk, 0, numSamples);
+        }
+
+        return file;
+    }
+
+    // Function to get a percentile from sorted timings
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const size_t index = jmin(sorted.size() - 1, (size_t) (p * (double) sorted.size()));
+        return sorted[index];
+    }
+
+    // Function to render a block like MainComponent, clearing it without the mixer when every deck is idle
+    void renderMix(MixerAudioSource& mixer, OwnedArray<DJAudioPlayer>& decks, const AudioSourceChannelInfo& info)
+    {
+        for (auto* deck : decks) {
+            if (!deck->isIdle()) {
+                mixer.getNextAudioBlock(info);
+                return;
+            }
+        }
+
+        info.clearActiveBufferRegion();
+        for (auto* deck : decks) {
+            deck->skipBlock();
+        }
+    }
+
+    // Function to render one case and return its timings
+    var runCase(AudioFormatManager& formatManager, const File& file, int blockSize,
+                double speed, int numDecks, bool playing, const Options& options)
+    {
+        // The decks decode on the render call, so the timings include the whole engine
+        OwnedArray<DJAudioPlayer> decks;
+        MixerAudioSource mixer;
+
+        for (int i = 0; i < numDecks; ++i) {
+            mixer.addInputSource(decks.add(new DJAudioPlayer(formatManager, false)), false);
+        }
+        mixer.prepareToPlay(blockSize, options.sampleRate);
+
+        for (int i = 0; i < numDecks; ++i) {
+            auto* deck = decks[i];
+            deck->loadURL(URL{ file });
+            deck->setGain(1.0 / numDecks);
+            deck->setSpeed(speed);
+            // Starting each deck somewhere else so they do not all read the same part of the file
+            deck->setPosition(i * 1.5);
+            if (playing) {
+                deck->start();
+            }
+        }
+
+        AudioBuffer<float> buffer(2, blockSize);
+        AudioSourceChannelInfo info(&buffer, 0, blockSize);
+
+        for (int i = 0; i < warmUpBlocks; ++i) {
+            renderMix(mixer, decks, info);
+        }
+
+        const int numBlocks = jmax(1, roundToInt(options.seconds * options.sampleRate / blockSize));
+        std::vector<double> blockNs;
+        blockNs.reserve((size_t) numBlocks);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            // A deck that reached the end of the file starts again, outside the timing
+            for (auto* deck : decks) {
+                if (playing && !deck->isPlaying()) {
+                    deck->setPosition(0);
+                    deck->start();
+                }
+            }
+
+            const int64 startTicks = Time::getHighResolutionTicks();
+            renderMix(mixer, decks, info);
+            const int64 endTicks = Time::getHighResolutionTicks();
+            blockNs.push_back(Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1.0e9);
+        }
+
+        mixer.removeAllInputs();
+        for (auto* deck : decks) {
+            deck->releaseResources();
+        }
+
+        double totalNs = 0;
+        for (double ns : blockNs) {
+            totalNs += ns;
+        }
+
+        const double deadlineNs = blockSize / options.sampleRate * 1.0e9;
+        int deadlineMisses = 0;
+        for (double ns : blockNs) {
+            if (ns > deadlineNs) {
+                ++deadlineMisses;
+            }
+        }
+
+        std::vector<double> sorted(blockNs);
+        std::sort(sorted.begin(), sorted.end());
+
+        DynamicObject::Ptr blockStats = new DynamicObject();
+        blockStats->setProperty("mean", totalNs / numBlocks);
+        blockStats->setProperty("p50", percentile(sorted, 0.5));
+        blockStats->setProperty("p90", percentile(sorted, 0.9));
+        blockStats->setProperty("p99", percentile(sorted, 0.99));
+        blockStats->setProperty("p999", percentile(sorted, 0.999));
+        blockStats->setProperty("max", sorted.back());
+        blockStats->setProperty("deadline", deadlineNs);
+
+        const double numSamples = (double) numBlocks * blockSize;
+
+        DynamicObject::Ptr result = new DynamicObject();
+        result->setProperty("source", file.getFileName());
+        result->setProperty("blockSize", blockSize);
+        result->setProperty("speed", speed);
+        result->setProperty("decks", numDecks);
+        result->setProperty("playing", playing);
+        result->setProperty("blocks", numBlocks);
+        result->setProperty("nsPerSample", totalNs / numSamples);
+        result->setProperty("nsPerDeckSample", totalNs / (numSamples * numDecks));
+        result->setProperty("blockNs", var(blockStats.get()));
+        result->setProperty("realtimeFactor", (numSamples / options.sampleRate) / (totalNs * 1.0e-9));
+        result->setProperty("deadlineMisses", deadlineMisses);
+        return var(result.get());
+    }
+
+    void printUsage()
+    {
+        std::cout << "OtoDecksBenchmark [options]\n"
+                     "  --files a.mp3,b.wav     real files to play as well as the synthetic one\n"
+                     "  --no-synthetic          only play the files given with --files\n"
+                     "  --block-sizes 64,256    block sizes to render\n"
+                     "  --speeds 0.5,1,2        speed ratios to set on every deck\n"
+                     "  --decks 1,2,4           numbers of decks to mix\n"
+                     "  --no-idle               skip the cases with every deck stopped\n"
+                     "  --sample-rate 48000     output sample rate\n"
+                     "  --seconds 10            seconds of audio rendered for each case\n"
+                     "  --output results.json   write the results to a file instead of stdout\n";
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        printUsage();
+        return 0;
+    }
+
+    Options options;
+    if (args.containsOption("--files")) {
+        for (auto& path : StringArray::fromTokens(args.getValueForOption("--files"), ",", "\"")) {
+            File file = File::getCurrentWorkingDirectory().getChildFile(path.trim());
+            if (!file.existsAsFile()) {
+                std::cerr << "No such file: " << file.getFullPathName() << std::endl;
+                return 1;
+            }
+            options.files.add(file);
+        }
+    }
+    if (args.containsOption("--block-sizes")) {
+        options.blockSizes = parseList<int>(args.getValueForOption("--block-sizes"));
+    }
+    if (args.containsOption("--speeds")) {
+        options.speeds = parseList<double>(args.getValueForOption("--speeds"));
+    }
+    if (args.containsOption("--decks")) {
+        options.deckCounts = parseList<int>(args.getValueForOption("--decks"));
+    }
+    if (args.containsOption("--sample-rate")) {
+        options.sampleRate = args.getValueForOption("--sample-rate").getDoubleValue();
+    }
+    if (args.containsOption("--seconds")) {
+        options.seconds = args.getValueForOption("--seconds").getDoubleValue();
+    }
+    if (args.containsOption("--output")) {
+        options.output = File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+    }
+    options.synthetic = !args.containsOption("--no-synthetic");
+    options.idle = !args.containsOption("--no-idle");
+
+    if (options.sampleRate <= 0 || options.seconds <= 0) {
+        std::cerr << "The sample rate and the seconds should be above 0" << std::endl;
+        return 1;
+    }
+
+    File syntheticFolder = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("OtoDecksBenchmark", "");
+    if (options.synthetic) {
+        syntheticFolder.createDirectory();
+        File file = writeSyntheticFile(syntheticFolder);
+        if (file == File()) {
+            syntheticFolder.deleteRecursively();
+            std::cerr << "Could not write the synthetic file" << std::endl;
+            return 1;
+        }
+        options.files.insert(0, file);
+    }
+
+    if (options.files.isEmpty()) {
+        std::cerr << "Nothing to play" << std::endl;
+        return 1;
+    }
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    Array<var> results;
+    for (auto& file : options.files) {
+        for (int blockSize : options.blockSizes) {
+            for (double speed : options.speeds) {
+                for (int numDecks : options.deckCounts) {
+                    if (blockSize <= 0 || speed <= 0 || numDecks <= 0) {
+                        continue;
+                    }
+                    std::cerr << file.getFileName() << " block " << blockSize << " speed " << speed
+                              << " decks " << numDecks << std::endl;
+                    results.add(runCase(formatManager, file, blockSize, speed, numDecks, true, options));
+                }
+            }
+
+            // A stopped deck does not depend on its speed, so the idle cases are only run once for each size
+            for (int numDecks : options.deckCounts) {
+                if (!options.idle || blockSize <= 0 || numDecks <= 0) {
+                    continue;
+                }
+                std::cerr << file.getFileName() << " block " << blockSize << " idle decks " << numDecks << std::endl;
+                results.add(runCase(formatManager, file, blockSize, 1.0, numDecks, false, options));
+            }
+        }
+    }
+
+    DynamicObject::Ptr report = new DynamicObject();
+    report->setProperty("juceVersion", SystemStats::getJUCEVersion());
+    report->setProperty("os", SystemStats::getOperatingSystemName());
+    report->setProperty("cpu", SystemStats::getCpuModel());
+    report->setProperty("numCpus", SystemStats::getNumCpus());
+    report->setProperty("sampleRate", options.sampleRate);
+    report->setProperty("secondsPerCase", options.seconds);
+    report->setProperty("results", results);
+
+    const String json = JSON::toString(var(report.get()));
+    syntheticFolder.deleteRecursively();
+
+    if (options.output != File()) {
+        if (!options.output.replaceWithText(json)) {
+            std::cerr << "Could not write " << options.output.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
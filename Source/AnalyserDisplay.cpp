@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    AnalyserDisplay.cpp
+    Created: 20 Oct 2026 4:31:09pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AnalyserDisplay.h"
+#include "Tracer.h"
+
+//==============================================================================
+AnalyserDisplay::AnalyserDisplay(AudioAnalyser& analyserToShow)
+                                 : analyser(analyserToShow)
+{
+    setOpaque(true);
+    setIdle(false);
+}
+
+AnalyserDisplay::~AnalyserDisplay()
+{
+}
+
+void AnalyserDisplay::paint(Graphics& g)
+{
+    TraceSpan span("AnalyserDisplay::paint");
+
+    g.fillAll(Colours::black);
+
+    auto bounds = getLocalBounds().reduced(2);
+    auto meterArea = bounds.removeFromLeft(jmin(30, bounds.getWidth() / 4));
+    bounds.removeFromLeft(4);
+
+    // Meters, the RMS as a bar and the peak hold as a line above it
+    const int meterWidth = meterArea.getWidth() / 2;
+    for (int ch = 0; ch < 2; ++ch) {
+        auto meter = meterArea.removeFromLeft(meterWidth).reduced(1, 0).toFloat();
+        g.setColour(Colours::darkgrey.darker());
+        g.fillRect(meter);
+
+        const float rmsHeight = meter.getHeight() * levelToProportion(analyser.getRms(ch));
+        const float peakHeight = meter.getHeight() * levelToProportion(analyser.getPeak(ch));
+        g.setColour(Colours::green.darker());
+        g.fillRect(meter.withTop(meter.getBottom() - peakHeight));
+        g.setColour(Colours::lightgreen);
+        g.fillRect(meter.withTop(meter.getBottom() - rmsHeight));
+
+        const float holdY = meter.getBottom() - meter.getHeight() * levelToProportion(peakHold[ch]);
+        g.setColour(peakHold[ch] >= 1.0f ? Colours::red : Colours::yellow);
+        g.fillRect(meter.getX(), holdY, meter.getWidth(), 2.0f);
+    }
+
+    // Spectrum
+    const Array<float>& spectrum = analyser.getSpectrum();
+    auto area = bounds.toFloat();
+    Path path;
+    for (int band = 0; band < spectrum.size(); ++band) {
+        const float x = area.getX() + area.getWidth() * band / (float) (spectrum.size() - 1);
+        const float level = jmap(spectrum[band], AudioAnalyser::minimumDecibels, 0.0f, 0.0f, 1.0f);
+        const float y = area.getBottom() - area.getHeight() * jlimit(0.0f, 1.0f, level);
+        if (band == 0) {
+            path.startNewSubPath(x, y);
+        }
+        else {
+            path.lineTo(x, y);
+        }
+    }
+    g.setColour(Colours::orange);
+    g.strokePath(path, PathStrokeType(1.5f));
+
+    g.setColour(Colours::red);
+    g.drawRect(getLocalBounds(), 1);
+}
+
+void AnalyserDisplay::updateFrame()
+{
+    analyser.update();
+
+    // The peak hold falls about 20dB a second at 60 frames a second
+    for (int ch = 0; ch < 2; ++ch) {
+        peakHold[ch] = jmax(analyser.getPeak(ch), peakHold[ch] * 0.96f);
+    }
+
+    // Nothing moves once the levels and the spectrum are at the bottom, so the last frame drawn stays up.
+    // A display that was just woken waits a second for the audio to reach it first
+    const bool silent = analyser.isSilent() && levelToProportion(jmax(peakHold[0], peakHold[1])) == 0.0f;
+    silentFrames = silent ? jmin(silentFrames + 1, framesBeforeIdle) : 0;
+    repaint();
+    setIdle(silentFrames >= framesBeforeIdle);
+}
+
+void AnalyserDisplay::setIdle(bool shouldBeIdle)
+{
+    if (shouldBeIdle == (vBlankAttachment == nullptr)) {
+        return;
+    }
+
+    if (shouldBeIdle) {
+        vBlankAttachment.reset();
+    }
+    else {
+        silentFrames = 0;
+        vBlankAttachment = std::make_unique<VBlankAttachment>(this, [this] { updateFrame(); });
+    }
+}
+
+void AnalyserDisplay::wake()
+{
+    setIdle(false);
+}
+
+float AnalyserDisplay::levelToProportion(float gain)
+{
+    return jlimit(0.0f, 1.0f, jmap(Decibels::gainToDecibels(gain, -60.0f), -60.0f, 0.0f, 0.0f, 1.0f));
+}
@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    AnalyserDisplay.h
+    Created: 20 Oct 2026 4:31:09pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioAnalyser.h"
+
+//==============================================================================
+/*
+    Shows an AudioAnalyser: a peak and RMS meter for each channel on the
+    left, with a falling peak hold, and the spectrum on the right. The
+    analyser is updated and the display redrawn once per display frame.
+
+    Once everything has fallen to silence the per-frame updates stop, and
+    nothing is checked until wake is called when a source may be playing.
+*/
+class AnalyserDisplay  : public Component
+{
+public:
+    AnalyserDisplay(AudioAnalyser& analyserToShow);
+    ~AnalyserDisplay() override;
+
+    void paint(Graphics&) override;
+
+    /** start updating every frame again, called when something that feeds the analyser may have started */
+    void wake();
+
+private:
+    // Function to update the analyser and the peak holds, called once per display frame
+    void updateFrame();
+
+    // Function to start or stop the per-frame updates, nothing is updated while the display is idle
+    void setIdle(bool shouldBeIdle);
+
+    // Function to get how far up the meter a level is, from -60dB at the bottom to 0dB at the top
+    static float levelToProportion(float gain);
+
+    AudioAnalyser& analyser;
+    float peakHold[2] = { 0.0f, 0.0f };
+
+    // Frames the display has been silent for, it goes idle after a second of them
+    int silentFrames = 0;
+    static constexpr int framesBeforeIdle = 60;
+
+    // Calls updateFrame in time with the display's refresh, null while the display is idle
+    std::unique_ptr<VBlankAttachment> vBlankAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalyserDisplay)
+};
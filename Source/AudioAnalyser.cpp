@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+
+    AudioAnalyser.cpp
+    Created: 20 Oct 2026 4:05:33pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AudioAnalyser.h"
+
+//==============================================================================
+namespace
+{
+    // Function to add up the squares of a block of samples, four or eight at a time
+    float sumOfSquares(const float* data, int numSamples)
+    {
+        using Register = dsp::SIMDRegister<float>;
+
+        // Going one sample at a time until the data is aligned for the SIMD loads
+        const float* aligned = Register::getNextSIMDAlignedPtr(const_cast<float*>(data));
+        const int head = jmin(numSamples, (int) (aligned - data));
+
+        float sum = 0.0f;
+        int i = 0;
+        for (; i < head; ++i) {
+            sum += data[i] * data[i];
+        }
+
+        Register total = Register::expand(0.0f);
+        for (; i + (int) Register::SIMDNumElements <= numSamples; i += (int) Register::SIMDNumElements) {
+            const Register samples = Register::fromRawArray(data + i);
+            total += samples * samples;
+        }
+        sum += total.sum();
+
+        for (; i < numSamples; ++i) {
+            sum += data[i] * data[i];
+        }
+        return sum;
+    }
+}
+
+//==============================================================================
+AudioAnalyser::AudioAnalyser()
+    : fifoBuffer(fifoSize, true),
+      history(fftSize, true),
+      incoming(fifoSize, true),
+      fftData(fftSize * 2, true)
+{
+    for (int ch = 0; ch < 2; ++ch) {
+        sumOfSquaresTotal[ch] = 0.0;
+        peakSinceRead[ch] = 0.0f;
+    }
+    spectrum.insertMultiple(0, minimumDecibels, numBands);
+}
+
+AudioAnalyser::~AudioAnalyser()
+{
+}
+
+void AudioAnalyser::prepareToPlay(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+}
+
+void AudioAnalyser::pushBlock(const AudioSourceChannelInfo& block)
+{
+    auto* buffer = block.buffer;
+    const int numSamples = block.numSamples;
+    const int numChannels = jmin(2, buffer->getNumChannels());
+    if (numChannels == 0 || numSamples <= 0) {
+        return;
+    }
+
+    // The message thread asks for a new peak by counting up its reads
+    const int reads = peakReads.load(std::memory_order_acquire);
+    if (reads != lastPeakReads) {
+        lastPeakReads = reads;
+        runningPeak[0] = runningPeak[1] = 0.0f;
+    }
+
+    for (int ch = 0; ch < 2; ++ch) {
+        const float* data = buffer->getReadPointer(jmin(ch, numChannels - 1), block.startSample);
+
+        const auto range = FloatVectorOperations::findMinAndMax(data, numSamples);
+        blockPeak[ch] = jmax(-range.getStart(), range.getEnd());
+        runningPeak[ch] = jmax(runningPeak[ch], blockPeak[ch]);
+        peakSinceRead[ch].store(runningPeak[ch], std::memory_order_relaxed);
+
+        const double total = sumOfSquaresTotal[ch].load(std::memory_order_relaxed);
+        sumOfSquaresTotal[ch].store(total + sumOfSquares(data, numSamples), std::memory_order_relaxed);
+    }
+    samplesTotal.store(samplesTotal.load(std::memory_order_relaxed) + numSamples, std::memory_order_release);
+
+    // Queueing a mono mix for the spectrum, anything that does not fit is dropped
+    const float* left = buffer->getReadPointer(0, block.startSample);
+    const float* right = buffer->getReadPointer(numChannels - 1, block.startSample);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    FloatVectorOperations::copyWithMultiply(fifoBuffer + start1, left, 0.5f, size1);
+    FloatVectorOperations::addWithMultiply(fifoBuffer + start1, right, 0.5f, size1);
+    if (size2 > 0) {
+        FloatVectorOperations::copyWithMultiply(fifoBuffer + start2, left + size1, 0.5f, size2);
+        FloatVectorOperations::addWithMultiply(fifoBuffer + start2, right + size1, 0.5f, size2);
+    }
+    fifo.finishedWrite(size1 + size2);
+}
+
+float AudioAnalyser::getBlockPeak(int channel) const
+{
+    return blockPeak[jlimit(0, 1, channel)];
+}
+
+void AudioAnalyser::update()
+{
+    // Levels since the last update
+    const int64 samples = samplesTotal.load(std::memory_order_acquire);
+    const int64 newSamples = samples - lastSamples;
+    lastSamples = samples;
+
+    for (int ch = 0; ch < 2; ++ch) {
+        const double sum = sumOfSquaresTotal[ch].load(std::memory_order_relaxed);
+        rms[ch] = newSamples > 0 ? (float) std::sqrt(jmax(0.0, sum - lastSumOfSquares[ch]) / (double) newSamples) : 0.0f;
+        lastSumOfSquares[ch] = sum;
+        peak[ch] = newSamples > 0 ? peakSinceRead[ch].load(std::memory_order_relaxed) : 0.0f;
+    }
+    peakReads.fetch_add(1, std::memory_order_release);
+
+    // Sliding the new samples into the end of the FFT window
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+    FloatVectorOperations::copy(incoming.get(), fifoBuffer + start1, size1);
+    FloatVectorOperations::copy(incoming + size1, fifoBuffer + start2, size2);
+    fifo.finishedRead(size1 + size2);
+
+    const int numNew = size1 + size2;
+    if (numNew == 0) {
+        for (int band = 0; band < numBands; ++band) {
+            spectrum.set(band, jmax(minimumDecibels, spectrum[band] - decayPerFrame));
+        }
+        updateSilent();
+        return;
+    }
+
+    if (numNew >= fftSize) {
+        FloatVectorOperations::copy(history.get(), incoming + numNew - fftSize, fftSize);
+    }
+    else if (numNew > 0) {
+        memmove(history.get(), history + numNew, sizeof(float) * (size_t) (fftSize - numNew));
+        FloatVectorOperations::copy(history + fftSize - numNew, incoming.get(), numNew);
+    }
+
+    FloatVectorOperations::copy(fftData.get(), history.get(), fftSize);
+    FloatVectorOperations::clear(fftData + fftSize, fftSize);
+    window.multiplyWithWindowingTable(fftData.get(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.get());
+
+    // Folding the bins into log spaced bands, which fall slowly so the display does not flicker
+    const double nyquist = sampleRate.load() / 2.0;
+    const double binsPerHz = fftSize / sampleRate.load();
+
+    for (int band = 0; band < numBands; ++band) {
+        const double lowHz = 20.0 * std::pow(nyquist / 20.0, (double) band / numBands);
+        const double highHz = 20.0 * std::pow(nyquist / 20.0, (double) (band + 1) / numBands);
+        const int lowBin = jlimit(0, fftSize / 2, (int) (lowHz * binsPerHz));
+        const int highBin = jlimit(lowBin + 1, fftSize / 2 + 1, (int) (highHz * binsPerHz));
+
+        float magnitude = 0.0f;
+        for (int bin = lowBin; bin < highBin; ++bin) {
+            magnitude = jmax(magnitude, fftData[bin]);
+        }
+
+        // A full scale sine reads 0dB, the Hann window halves the magnitude of the bin it falls in
+        const float decibels = Decibels::gainToDecibels(magnitude * 4.0f / fftSize, minimumDecibels);
+        spectrum.set(band, jmax(decibels, spectrum[band] - decayPerFrame));
+    }
+    updateSilent();
+}
+
+void AudioAnalyser::updateSilent()
+{
+    silent = peak[0] == 0.0f && peak[1] == 0.0f;
+    for (int band = 0; band < numBands && silent; ++band) {
+        silent = spectrum[band] <= minimumDecibels;
+    }
+}
+
+float AudioAnalyser::getPeak(int channel) const
+{
+    return peak[jlimit(0, 1, channel)];
+}
+
+float AudioAnalyser::getRms(int channel) const
+{
+    return rms[jlimit(0, 1, channel)];
+}
+
+const Array<float>& AudioAnalyser::getSpectrum() const
+{
+    return spectrum;
+}
+
+bool AudioAnalyser::isSilent() const
+{
+    return silent;
+}
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    AudioAnalyser.h
+    Created: 20 Oct 2026 4:05:33pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Peak and RMS levels and a spectrum for one stereo signal.
+
+    The audio thread only measures each block's peak and sum of squares with
+    SIMD, and copies a mono mix of the block into a lock-free FIFO. Everything
+    else happens in update on the message thread, once per frame: the levels
+    since the last frame are worked out from the running totals, and the FFT
+    is run on the latest samples and folded into log spaced bands. A frame
+    with no new samples, from a deck that is not being rendered, skips the
+    FFT and lets the bands fall.
+*/
+class AudioAnalyser
+{
+public:
+    AudioAnalyser();
+    ~AudioAnalyser();
+
+    void prepareToPlay(double sampleRate);
+
+    /** measure a block and queue it for the spectrum, called on the audio thread */
+    void pushBlock(const AudioSourceChannelInfo& block);
+
+    /** get the peak of the last block pushed, only for use on the audio thread */
+    float getBlockPeak(int channel) const;
+
+    /** take everything pushed since the last call and update the levels and spectrum, called once per frame */
+    void update();
+
+    /** get the peak and RMS levels of a channel between the last two updates, as gains */
+    float getPeak(int channel) const;
+    float getRms(int channel) const;
+
+    /** get the level of each band of the spectrum in decibels, from 20Hz up to half the sample rate */
+    const Array<float>& getSpectrum() const;
+
+    /** true when the last update found nothing but silence and the spectrum has fallen to the bottom */
+    bool isSilent() const;
+
+    static constexpr int numBands = 64;
+    static constexpr float minimumDecibels = -90.0f;
+
+private:
+    // Function to work out whether the last update was silent
+    void updateSilent();
+
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int fifoSize = 8192;
+
+    // Written by the audio thread only, the message thread reads the difference since its last update
+    std::atomic<double> sumOfSquaresTotal[2];
+    std::atomic<int64> samplesTotal{ 0 };
+    std::atomic<float> peakSinceRead[2];
+    std::atomic<int> peakReads{ 0 };
+    std::atomic<double> sampleRate{ 44100.0 };
+
+    // Only touched by the audio thread
+    float blockPeak[2] = { 0.0f, 0.0f };
+    float runningPeak[2] = { 0.0f, 0.0f };
+    int lastPeakReads = 0;
+
+    AbstractFifo fifo{ fifoSize };
+    HeapBlock<float> fifoBuffer;
+
+    // Only touched by the message thread
+    double lastSumOfSquares[2] = { 0.0, 0.0 };
+    int64 lastSamples = 0;
+    float peak[2] = { 0.0f, 0.0f };
+    float rms[2] = { 0.0f, 0.0f };
+
+    bool silent = true;
+
+    // How far a band falls each frame, so the display does not flicker
+    static constexpr float decayPerFrame = 1.5f;
+
+    dsp::FFT fft{ fftOrder };
+    dsp::WindowingFunction<float> window{ (size_t) fftSize, dsp::WindowingFunction<float>::hann };
+    HeapBlock<float> history;
+    HeapBlock<float> incoming;
+    HeapBlock<float> fftData;
+    Array<float> spectrum;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioAnalyser)
+};
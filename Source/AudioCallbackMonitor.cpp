@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    AudioCallbackMonitor.cpp
+    Created: 19 Oct 2026 5:03:18pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AudioCallbackMonitor.h"
+
+//==============================================================================
+namespace
+{
+    // A callback that starts this much later than the block before it should have, has made the device wait
+    const double lateCallbackFactor = 1.5;
+
+    // Function to add to a counter that only one thread writes, without a locked instruction
+    template <typename Type>
+    inline void bump(std::atomic<Type>& counter, Type amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+AudioCallbackMonitor::AudioCallbackMonitor(const StringArray& sectionNames)
+{
+    for (auto& name : sectionNames) {
+        sections.add(new Section())->name = name;
+    }
+
+    history.resize((size_t) numSnapshots, std::vector<Snapshot>((size_t) sections.size()));
+    lateHistory.resize((size_t) numSnapshots, 0);
+    ticksToNs = 1.0e9 / (double) Time::getHighResolutionTicksPerSecond();
+    lastLogTime = Time::getMillisecondCounter();
+
+    startTimer(snapshotIntervalMs);
+}
+
+AudioCallbackMonitor::~AudioCallbackMonitor()
+{
+    stopTimer();
+}
+
+void AudioCallbackMonitor::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    blockSize = samplesPerBlockExpected;
+    lastCallbackTicks = 0;
+}
+
+void AudioCallbackMonitor::setDeviceManager(AudioDeviceManager* manager)
+{
+    deviceManager = manager;
+}
+
+void AudioCallbackMonitor::setLogInterval(int seconds)
+{
+    logInterval = jmax(0, seconds);
+}
+
+String AudioCallbackMonitor::getReport() const
+{
+    return report;
+}
+
+AudioCallbackMonitor::Headroom AudioCallbackMonitor::getHeadroom() const
+{
+    return headroom;
+}
+
+void AudioCallbackMonitor::record(int sectionIndex, int64 startTicks, int64 endTicks, int numSamples) noexcept
+{
+    auto* section = sections[sectionIndex];
+    const double rate = sampleRate.load(std::memory_order_relaxed);
+    if (section == nullptr || rate <= 0) {
+        return;
+    }
+
+    const uint64 ns = (uint64) ((double) (endTicks - startTicks) * ticksToNs);
+    const double budgetNs = numSamples * 1.0e9 / rate;
+
+    bump(section->buckets[bucketFor(ns)], (uint32) 1);
+    bump(section->blocks, (uint64) 1);
+    bump(section->totalNs, ns);
+    if ((double) ns > budgetNs) {
+        bump(section->deadlineMisses, (uint64) 1);
+    }
+
+    // The whole callback also checks how long it has been since the one before it started
+    if (sectionIndex == 0) {
+        if (lastCallbackTicks != 0 && (double) (startTicks - lastCallbackTicks) * ticksToNs > budgetNs * lateCallbackFactor) {
+            bump(lateCallbacks, (uint64) 1);
+        }
+        lastCallbackTicks = startTicks;
+    }
+}
+
+int AudioCallbackMonitor::bucketFor(uint64 ns) noexcept
+{
+    const uint32 units = (uint32) jmin(ns >> 8, (uint64) 0xffffffff);
+    if (units == 0) {
+        return 0;
+    }
+
+    // 256ns to 512ns has a bucket of its own, as it has no bit below the highest one to split it by
+    const int octave = findHighestSetBit(units) + 1;
+    if (octave == 1) {
+        return 1;
+    }
+
+    // Each later doubling of the time is split in two, by the bit below the highest one
+    const int half = (int) ((units >> (octave - 2)) & 1);
+    return jmin(numBuckets - 1, octave * 2 - 2 + half);
+}
+
+double AudioCallbackMonitor::bucketLimitMicros(int bucket)
+{
+    if (bucket <= 1) {
+        return bucket == 0 ? 0.256 : 0.512;
+    }
+
+    const int octave = bucket / 2 + 1;
+    const bool upperHalf = bucket % 2 == 1;
+    const double octaveStart = std::ldexp(256.0, octave - 1);
+    return (upperHalf ? octaveStart * 2.0 : octaveStart * 1.5) / 1000.0;
+}
+
+void AudioCallbackMonitor::timerCallback()
+{
+    // The oldest snapshot is replaced by the newest one, and the difference between them is the rolling window
+    const int oldest = (newestSnapshot + 1) % numSnapshots;
+    const int window = jmin(snapshotsTaken, numSnapshots - 1);
+    newestSnapshot = oldest;
+    ++snapshotsTaken;
+
+    const double rate = sampleRate.load();
+    String text;
+
+    for (int s = 0; s < sections.size(); ++s)
+    {
+        auto& now = history[(size_t) newestSnapshot][(size_t) s];
+        const auto& section = *sections[s];
+        for (int b = 0; b < numBuckets; ++b) {
+            now.buckets[b] = section.buckets[b].load(std::memory_order_relaxed);
+        }
+        now.blocks = section.blocks.load(std::memory_order_relaxed);
+        now.totalNs = section.totalNs.load(std::memory_order_relaxed);
+        now.deadlineMisses = section.deadlineMisses.load(std::memory_order_relaxed);
+
+        const auto& then = history[(size_t) ((newestSnapshot + numSnapshots - window) % numSnapshots)][(size_t) s];
+        const uint64 blocks = now.blocks - then.blocks;
+
+        double p50 = 0, p99 = 0, worst = 0;
+        uint64 counted = 0;
+        for (int b = 0; b < numBuckets; ++b) {
+            const uint32 count = now.buckets[b] - then.buckets[b];
+            if (count == 0) {
+                continue;
+            }
+            counted += count;
+            if (p50 == 0 && counted * 2 >= blocks) {
+                p50 = bucketLimitMicros(b);
+            }
+            if (p99 == 0 && counted * 100 >= blocks * 99) {
+                p99 = bucketLimitMicros(b);
+            }
+            worst = bucketLimitMicros(b);
+        }
+
+        if (s == 0) {
+            headroom.p99Ms = p99 / 1000.0;
+            headroom.worstMs = worst / 1000.0;
+            headroom.deadlineMisses = (int64) (now.deadlineMisses - then.deadlineMisses);
+        }
+
+        const double mean = blocks > 0 ? (double) (now.totalNs - then.totalNs) / (double) blocks / 1000.0 : 0.0;
+        text << section.name.paddedRight(' ', 10)
+             << "blocks " << String((int64) blocks).paddedLeft(' ', 6)
+             << "  mean " << String(mean, 1) << "us"
+             << "  p50 <" << String(p50, 1) << "us"
+             << "  p99 <" << String(p99, 1) << "us"
+             << "  max <" << String(worst, 1) << "us"
+             << "  misses " << String((int64) (now.deadlineMisses - then.deadlineMisses)) << "\n";
+    }
+
+    lateHistory[(size_t) newestSnapshot] = lateCallbacks.load(std::memory_order_relaxed);
+    const uint64 late = lateHistory[(size_t) newestSnapshot] - lateHistory[(size_t) ((newestSnapshot + numSnapshots - window) % numSnapshots)];
+
+    const int xruns = (deviceManager != nullptr && deviceManager->getCurrentAudioDevice() != nullptr)
+                          ? deviceManager->getCurrentAudioDevice()->getXRunCount() : -1;
+
+    headroom.blockSize = blockSize.load();
+    headroom.sampleRate = rate;
+    headroom.budgetMs = rate > 0 ? headroom.blockSize * 1000.0 / rate : 0.0;
+    headroom.lateCallbacks = (int64) late;
+    headroom.xruns = xruns;
+
+    text << "late callbacks " << String((int64) late)
+         << "  device xruns " << (xruns >= 0 ? String(xruns) : String("n/a"))
+         << "  sample rate " << String(rate, 0) << "Hz";
+    report = text;
+
+    // Writing the report to the log every so often
+    const int64 nowMs = Time::getMillisecondCounter();
+    if (logInterval > 0 && nowMs - lastLogTime >= logInterval * 1000) {
+        lastLogTime = nowMs;
+        Logger::writeToLog("Audio callback timing over the last " + String(window * snapshotIntervalMs / 1000.0, 1) + "s\n" + report);
+    }
+}
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    AudioCallbackMonitor.h
+    Created: 19 Oct 2026 5:03:18pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Times the audio callback and each deck's render without locking or waiting.
+
+    The audio thread only bumps relaxed atomic counters in a log scaled
+    histogram for each section, with one high resolution clock read at each
+    end of the section. A timer on the message thread takes snapshots of the
+    counters, and the difference from the snapshot a few seconds earlier gives
+    rolling percentiles, deadline misses and late callbacks. The report is
+    shown by the performance overlay and written to the log every so often.
+*/
+class AudioCallbackMonitor  : private Timer
+{
+public:
+    /** section 0 is the whole callback, the others are named by the caller */
+    explicit AudioCallbackMonitor(const StringArray& sectionNames);
+    ~AudioCallbackMonitor() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /** give the monitor the device manager so it can report the device's own xrun count */
+    void setDeviceManager(AudioDeviceManager* manager);
+
+    /** write the report to the log every so many seconds, or never with 0 */
+    void setLogInterval(int seconds);
+
+    /** get the latest report, on the message thread */
+    String getReport() const;
+
+    /** how the whole callback compares to its deadline over the rolling window */
+    struct Headroom
+    {
+        int blockSize = 0;
+        double sampleRate = 0;
+        double budgetMs = 0;
+        double p99Ms = 0;
+        double worstMs = 0;
+        int64 deadlineMisses = 0;
+        int64 lateCallbacks = 0;
+        int xruns = -1;
+    };
+
+    /** get the latest headroom of the whole callback, on the message thread */
+    Headroom getHeadroom() const;
+
+    /** times a section of the audio thread from its construction to its destruction */
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(AudioCallbackMonitor* monitorToUse, int sectionIndex, int numSamples) noexcept
+            : monitor(monitorToUse), section(sectionIndex), samples(numSamples),
+              startTicks(monitorToUse != nullptr ? Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~ScopedTimer() noexcept
+        {
+            if (monitor != nullptr) {
+                monitor->record(section, startTicks, Time::getHighResolutionTicks(), samples);
+            }
+        }
+
+    private:
+        AudioCallbackMonitor* monitor;
+        int section;
+        int samples;
+        int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimer)
+    };
+
+private:
+    void timerCallback() override;
+
+    // Function to add a timing to a section's counters, on the audio thread
+    void record(int section, int64 startTicks, int64 endTicks, int numSamples) noexcept;
+
+    // Function to get the histogram bucket for a time, two buckets per doubling from 512ns
+    static int bucketFor(uint64 ns) noexcept;
+
+    // Function to get the longest time that falls into a bucket
+    static double bucketLimitMicros(int bucket);
+
+    static constexpr int numBuckets = 40;
+
+    // Snapshots are taken four times a second and the rolling window covers five seconds
+    static constexpr int snapshotIntervalMs = 250;
+    static constexpr int numSnapshots = 20;
+
+    // Counters written by the audio thread only
+    struct Section
+    {
+        String name;
+        std::atomic<uint32> buckets[numBuckets] = {};
+        std::atomic<uint64> blocks{ 0 };
+        std::atomic<uint64> totalNs{ 0 };
+        std::atomic<uint64> deadlineMisses{ 0 };
+    };
+
+    // A copy of a section's counters taken by the timer
+    struct Snapshot
+    {
+        uint32 buckets[numBuckets] = {};
+        uint64 blocks = 0;
+        uint64 totalNs = 0;
+        uint64 deadlineMisses = 0;
+    };
+
+    OwnedArray<Section> sections;
+    std::atomic<uint64> lateCallbacks{ 0 };
+    std::atomic<double> sampleRate{ 0.0 };
+    std::atomic<int> blockSize{ 0 };
+    double ticksToNs = 0;
+
+    // Only touched by the audio thread
+    int64 lastCallbackTicks = 0;
+
+    // Only touched by the message thread
+    std::vector<std::vector<Snapshot>> history;
+    std::vector<uint64> lateHistory;
+    int newestSnapshot = 0;
+    int snapshotsTaken = 0;
+    AudioDeviceManager* deviceManager = nullptr;
+    int logInterval = 60;
+    int64 lastLogTime = 0;
+    String report;
+    Headroom headroom;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioCallbackMonitor)
+};
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    AudioSettingsComponent.cpp
+    Created: 19 Oct 2026 8:02:47pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AudioSettingsComponent.h"
+
+//==============================================================================
+AudioSettingsComponent::AudioSettingsComponent(AudioDeviceManager& deviceManagerToUse,
+                                               AudioCallbackMonitor& monitorToShow,
+                                               MidiRouter& midiRouterToUse)
+                                               : monitor(monitorToShow),
+                                                 midiRouter(midiRouterToUse),
+                                                 deviceSelector(deviceManagerToUse, 0, 0, 2, 2, true, false, true, false)
+{
+    addAndMakeVisible(deviceSelector);
+
+    headroomLabel.setColour(Label::textColourId, Colours::white);
+    headroomLabel.setJustificationType(Justification::topLeft);
+    addAndMakeVisible(headroomLabel);
+
+    // The test sends probes out of a virtual port, which is connected back to the virtual controller input
+    latencyTestButton.setToggleState(midiRouter.isLatencyTestRunning(), dontSendNotification);
+    latencyTestButton.setTooltip("Connect \"OtoDecks Latency Probe\" to \"OtoDecks Controller\", e.g. with aconnect");
+    latencyTestButton.onClick = [this] {
+        midiRouter.setLatencyTest(latencyTestButton.getToggleState());
+        latencyTestButton.setToggleState(midiRouter.isLatencyTestRunning(), dontSendNotification);
+    };
+    addAndMakeVisible(latencyTestButton);
+
+    midiLatencyLabel.setColour(Label::textColourId, Colours::white);
+    midiLatencyLabel.setJustificationType(Justification::topLeft);
+    addAndMakeVisible(midiLatencyLabel);
+
+    setSize(500, 600);
+    timerCallback();
+    startTimer(250);
+}
+
+AudioSettingsComponent::~AudioSettingsComponent()
+{
+    stopTimer();
+    midiRouter.setLatencyTest(false);
+}
+
+void AudioSettingsComponent::paint (juce::Graphics& g)
+{
+    g.fillAll(Colours::black);
+
+    g.setColour(Colours::orange);
+    g.drawLine(10.0f, (float) headroomLabel.getY() - 6.0f, (float) getWidth() - 10.0f, (float) headroomLabel.getY() - 6.0f);
+}
+
+void AudioSettingsComponent::resized()
+{
+    deviceSelector.setBounds(0, 0, getWidth(), getHeight() - 170);
+    headroomLabel.setBounds(10, getHeight() - 160, getWidth() - 20, 75);
+    latencyTestButton.setBounds(10, getHeight() - 80, 160, 24);
+    midiLatencyLabel.setBounds(10, getHeight() - 55, getWidth() - 20, 50);
+}
+
+void AudioSettingsComponent::timerCallback()
+{
+    updateMidiLatency();
+
+    const auto headroom = monitor.getHeadroom();
+
+    if (headroom.budgetMs <= 0) {
+        headroomLabel.setText("The audio device is not running", dontSendNotification);
+        headroomLabel.setColour(Label::textColourId, Colours::white);
+        return;
+    }
+
+    // Showing how much of the buffer's time the slowest callbacks take
+    const double used = headroom.p99Ms / headroom.budgetMs;
+    String text;
+    text << "Buffer " << headroom.blockSize << " samples at " << String(headroom.sampleRate, 0)
+         << "Hz gives the callback " << String(headroom.budgetMs, 2) << "ms\n"
+         << "Last 5s: p99 under " << String(headroom.p99Ms, 2) << "ms (" << roundToInt(used * 100.0)
+         << "% of the buffer), slowest under " << String(headroom.worstMs, 2) << "ms\n"
+         << "Deadline misses " << headroom.deadlineMisses << ", late callbacks " << headroom.lateCallbacks
+         << ", device xruns " << (headroom.xruns >= 0 ? String(headroom.xruns) : String("n/a"));
+    headroomLabel.setText(text, dontSendNotification);
+
+    // Green while there is plenty of headroom, orange when it is getting tight, red when buffers are missed
+    Colour colour = Colours::lightgreen;
+    if (headroom.deadlineMisses > 0 || headroom.lateCallbacks > 0 || used >= 0.8) {
+        colour = Colours::red;
+    }
+    else if (used >= 0.5) {
+        colour = Colours::orange;
+    }
+    headroomLabel.setColour(Label::textColourId, colour);
+}
+
+void AudioSettingsComponent::updateMidiLatency()
+{
+    const auto latency = midiRouter.getLatencyStats();
+
+    // From a message arriving to the sample it lands on, which includes the block it waits for to keep its timing
+    String text;
+    if (latency.messages > 0) {
+        text << "MIDI: " << latency.messages << " messages, " << String(latency.averageMs, 2)
+             << "ms to the deck on average, slowest " << String(latency.worstMs, 2) << "ms\n";
+    }
+    else {
+        text << "MIDI: no controller messages\n";
+    }
+
+    if (midiRouter.isLatencyTestRunning()) {
+        if (latency.probes > 0) {
+            text << "Probe round trip: " << String(latency.probeAverageMs, 2) << "ms on average, slowest "
+                 << String(latency.probeWorstMs, 2) << "ms";
+        }
+        else {
+            text << "Waiting for probes, is the probe port connected to the controller input?";
+        }
+    }
+    midiLatencyLabel.setText(text, dontSendNotification);
+}
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    AudioSettingsComponent.h
+    Created: 19 Oct 2026 8:02:47pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioCallbackMonitor.h"
+#include "MidiRouter.h"
+
+//==============================================================================
+/*
+    Lets the user pick the audio backend, device, sample rate, buffer size and
+    MIDI inputs, and shows live how much of each buffer's time the audio
+    callback uses and how long MIDI messages take to reach the decks.
+*/
+class AudioSettingsComponent  : public juce::Component,
+                                private Timer
+{
+public:
+    AudioSettingsComponent(AudioDeviceManager& deviceManagerToUse,
+                           AudioCallbackMonitor& monitorToShow,
+                           MidiRouter& midiRouterToUse);
+    ~AudioSettingsComponent() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+
+    // Function to show the MIDI latencies measured since the last update
+    void updateMidiLatency();
+
+    AudioCallbackMonitor& monitor;
+    MidiRouter& midiRouter;
+    AudioDeviceSelectorComponent deviceSelector;
+    Label headroomLabel;
+    ToggleButton latencyTestButton{ "MIDI latency test" };
+    Label midiLatencyLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioSettingsComponent)
+};
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    AutoDJ.cpp
+    Created: 19 Oct 2026 3:58:12pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AutoDJ.h"
+
+//==============================================================================
+AutoDJ::AutoDJ(DJAudioPlayer& deck1,
+               DJAudioPlayer& deck2,
+               std::function<void(URL, int)> loadTrackOnDeck)
+               : loadTrack(std::move(loadTrackOnDeck))
+{
+    decks[0] = &deck1;
+    decks[1] = &deck2;
+}
+
+AutoDJ::~AutoDJ()
+{
+    stopTimer();
+}
+
+void AutoDJ::start(const Array<File>& tracks)
+{
+    stop();
+
+    queue = tracks;
+    nextInQueue = 0;
+
+    // Starting the first track on deck 1 straight away
+    if (!loadNext(0, false)) {
+        return;
+    }
+    decks[0]->start();
+    activeDeck = 0;
+    running = true;
+
+    // Arming the next track on deck 2 so it is ready long before the crossfade
+    nextArmed = loadNext(1, true);
+    startTimer(100);
+}
+
+void AutoDJ::stop()
+{
+    running = false;
+    stopTimer();
+
+    // Disarming the waiting deck and putting the crossfade gains back
+    for (auto* deck : decks) {
+        if (deck->isArmed()) {
+            deck->stop();
+        }
+        deck->setMixGain(1.0f);
+    }
+
+    activeDeck = -1;
+    nextArmed = false;
+    fadeStarted = false;
+    fadeFinished = false;
+}
+
+bool AutoDJ::isRunning() const
+{
+    return running;
+}
+
+void AutoDJ::setCrossfadeSeconds(double seconds)
+{
+    crossfadeSeconds = jmax(0.0, seconds);
+}
+
+double AutoDJ::getCrossfadeSeconds() const
+{
+    return crossfadeSeconds;
+}
+
+void AutoDJ::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    fading = false;
+}
+
+void AutoDJ::processBlock(int numSamples)
+{
+    const int active = activeDeck.load();
+    if (!running || active < 0 || !nextArmed || fadeFinished) {
+        return;
+    }
+
+    auto* outgoing = decks[active];
+    auto* incoming = decks[1 - active];
+
+    if (!fading) {
+        // Starting the next deck on the sample where the remaining time equals the crossfade length
+        const double remaining = outgoing->getRemainingSeconds();
+        const double fadeSeconds = jmin(crossfadeSeconds.load(), remaining);
+        const int64 samplesUntilFade = (int64) ((remaining - crossfadeSeconds.load()) * sampleRate);
+
+        if (samplesUntilFade >= numSamples) {
+            return;
+        }
+
+        const int offset = (int) jlimit((int64) 0, (int64) numSamples - 1, samplesUntilFade);
+        incoming->releaseArmedStart(offset);
+        fadeStarted = true;
+
+        fading = true;
+        fadeLength = jmax((int64) 1, (int64) (fadeSeconds * sampleRate));
+        fadePosition = -offset;
+    }
+
+    // Equal power crossfade, the gains are ramped over each block by the decks
+    fadePosition += numSamples;
+    const double progress = jlimit(0.0, 1.0, (double) fadePosition / (double) fadeLength);
+    outgoing->setMixGain((float) std::cos(progress * MathConstants<double>::halfPi));
+    incoming->setMixGain((float) std::sin(progress * MathConstants<double>::halfPi));
+
+    if (progress >= 1.0) {
+        fading = false;
+        fadeFinished = true;
+    }
+}
+
+void AutoDJ::timerCallback()
+{
+    if (!running) {
+        return;
+    }
+
+    const int active = activeDeck.load();
+
+    // The audio thread has started the next deck, which is woken here as the audio thread cannot post messages
+    if (fadeStarted.exchange(false)) {
+        decks[1 - active]->wakeDisplays();
+    }
+
+    if (fadeFinished) {
+        // The old deck has faded out, so it is stopped and becomes the deck for the next track
+        decks[active]->stop();
+        decks[active]->setMixGain(1.0f);
+        decks[1 - active]->setMixGain(1.0f);
+
+        activeDeck = 1 - active;
+        nextArmed = loadNext(active, true);
+        fadeFinished = false;
+    }
+    else if (!nextArmed && !decks[active]->isPlaying()) {
+        // The last track of the queue has finished
+        stop();
+    }
+}
+
+bool AutoDJ::loadNext(int deck, bool arm)
+{
+    while (nextInQueue < queue.size()) {
+        File track = queue[nextInQueue++];
+        if (!track.existsAsFile()) {
+            continue;
+        }
+
+        decks[deck]->setMixGain(arm ? 0.0f : 1.0f);
+        loadTrack(URL{ track }, deck + 1);
+        if (arm) {
+            decks[deck]->armStart();
+        }
+        return true;
+    }
+    return false;
+}
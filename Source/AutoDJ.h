@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    AutoDJ.h
+    Created: 19 Oct 2026 3:58:12pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include "DJAudioPlayer.h"
+
+//==============================================================================
+/*
+    Plays through a queue of tracks from the playlist on the two decks.
+
+    While one deck plays, the next track in the queue is loaded on the other
+    deck and armed, so it is opened and read ahead long before it is needed.
+    The audio thread starts the armed deck on the exact sample where the
+    crossfade should begin and fades between the decks with equal power
+    curves. When the fade is done, the message thread stops the old deck and
+    loads the following track on it.
+*/
+class AutoDJ  : private Timer
+{
+public:
+    AutoDJ(DJAudioPlayer& deck1,
+           DJAudioPlayer& deck2,
+           std::function<void(URL, int)> loadTrackOnDeck);
+    ~AutoDJ() override;
+
+    /** start playing through a queue of tracks */
+    void start(const Array<File>& tracks);
+    void stop();
+    bool isRunning() const;
+
+    /** set how many seconds before the end of a track the next one starts */
+    void setCrossfadeSeconds(double seconds);
+    double getCrossfadeSeconds() const;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /** called at the start of every audio block, before the decks are rendered */
+    void processBlock(int numSamples);
+
+private:
+    void timerCallback() override;
+
+    // Function to load the next track of the queue on a deck, arming it to wait for the crossfade
+    bool loadNext(int deck, bool arm);
+
+    DJAudioPlayer* decks[2];
+    std::function<void(URL, int)> loadTrack;
+
+    Array<File> queue;
+    int nextInQueue = 0;
+
+    std::atomic<bool> running{ false };
+    std::atomic<int> activeDeck{ -1 };
+    std::atomic<bool> nextArmed{ false };
+    std::atomic<bool> fadeStarted{ false };
+    std::atomic<bool> fadeFinished{ false };
+    std::atomic<double> crossfadeSeconds{ 8.0 };
+
+    // Only touched by the audio thread
+    double sampleRate = 44100;
+    bool fading = false;
+    int64 fadePosition = 0;
+    int64 fadeLength = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutoDJ)
+};
@@ -10,29 +10,336 @@
 
 #include <JuceHeader.h>
 #include "DJAudioPlayer.h"
+#include "Tracer.h"
 
 //==============================================================================
-DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager)
-                            : formatManager(_formatManager)
+DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager, bool useReadAheadThread)
+                            : formatManager(_formatManager),
+                              useReadAhead(useReadAheadThread)
 {
     // In your constructor, you should add any child components, and
     // initialise any special settings that your component needs.
 
+    // Offline decks decode in the render call, so they never start the thread. Their hot cue buffers are not
+    // rendered either, which the offline tools do not use
+    if (useReadAhead) {
+        readAheadThread.startThread(Thread::Priority::high);
+    }
 }
 
 DJAudioPlayer::~DJAudioPlayer()
 {
+    cancelPendingUpdate();
+    streamLoader.cancel();
+    transportSource.setSource(nullptr);
+    readerSource.reset();
+    readAheadThread.stopThread(2000);
+    streamThread.stopThread(2000);
 }
 
 void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
     transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
     resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    scrubEngine.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    analyser.prepareToPlay(sampleRate);
+    currentSampleRate = sampleRate;
 }
 void DJAudioPlayer::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
 {
-    resampleSource.getNextAudioBlock(bufferToFill);
+    AudioCallbackMonitor::ScopedTimer timer(monitor, monitorSection, bufferToFill.numSamples);
+    TraceSpan span("DJAudioPlayer::getNextAudioBlock");
+
+    // A stopped deck only clears the block, without pulling the transport through the resampler
+    if (isIdle()) {
+        bufferToFill.clearActiveBufferRegion();
+        skipBlock();
+        return;
+    }
+
+    updateSlip();
+
+    // Rendering up to the sample of each controller command, so every command lands on its own sample
+    int rendered = 0;
+    for (int i = 0; i < numQueuedCommands; ++i) {
+        const int offset = jlimit(rendered, bufferToFill.numSamples, queuedCommands[i].sampleOffset);
+        if (offset > rendered) {
+            renderSection(bufferToFill, rendered, offset - rendered);
+            rendered = offset;
+        }
+        applyCommand(queuedCommands[i].command);
+    }
+    numQueuedCommands = 0;
+
+    if (rendered < bufferToFill.numSamples) {
+        renderSection(bufferToFill, rendered, bufferToFill.numSamples - rendered);
+    }
+
+    // The jog wheel only bends the speed while it turns, so the bend falls back after every block
+    if (jogBend != 0) {
+        jogBend *= std::exp(-bufferToFill.numSamples / (jogReleaseSeconds * currentSampleRate));
+        if (std::abs(jogBend) < 0.0001) {
+            jogBend = 0;
+        }
+    }
+
+    // Ramping the crossfade gain over the block so it never clicks
+    const float gain = mixGain.load();
+    if (gain != 1.0f || lastMixGain != 1.0f) {
+        bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, lastMixGain, gain);
+        lastMixGain = gain;
+    }
+
+    silentBlocks = isSilent() ? jmin(silentBlocks + 1, blocksBeforeIdle) : 0;
 
+    // The block is measured as it leaves the deck, after the crossfade gain
+    analyser.pushBlock(bufferToFill);
+    publishSnapshot(analyser.getBlockPeak(0), analyser.getBlockPeak(1));
+}
+
+bool DJAudioPlayer::isIdle() const
+{
+    // Anything started from the message thread, or queued by a controller, renders again from the next block
+    return silentBlocks >= blocksBeforeIdle && numQueuedCommands == 0 && isSilent();
+}
+
+bool DJAudioPlayer::isSilent() const
+{
+    if (scrubbing) {
+        return false;
+    }
+    return !transportSource.isPlaying() || (armed && armedStartOffset.load() < 0);
+}
+
+void DJAudioPlayer::skipBlock()
+{
+    // Nothing is playing, so the gains are caught up without a ramp and the analyser is left without a block
+    lastMixGain = mixGain.load();
+    jogBend = 0;
+    slipPosition = -1.0;
+    publishSnapshot(0.0f, 0.0f);
+}
+
+void DJAudioPlayer::renderSection(const AudioSourceChannelInfo& bufferToFill, int start, int numSamples)
+{
+    const AudioSourceChannelInfo section(bufferToFill.buffer, bufferToFill.startSample + start, numSamples);
+    if (!armed) {
+        renderAudible(section);
+        return;
+    }
+
+    // An armed deck stays silent, without moving its playhead, until it is released. A deck that was heard is
+    // faded out first, as the transport does when it stops, which moves the playhead on by the fade
+    const int offset = armedStartOffset.load();
+    if (offset < 0 || offset >= start + numSamples) {
+        const bool fadeOut = !heldSilent && offset != heldWithoutFade;
+        heldSilent = true;
+
+        const int fade = fadeOut ? jmin(numSamples, holdFadeSamples) : 0;
+        if (fade > 0) {
+            renderBlock(AudioSourceChannelInfo(bufferToFill.buffer, section.startSample, fade));
+            bufferToFill.buffer->applyGainRamp(section.startSample, fade, 1.0f, 0.0f);
+        }
+        bufferToFill.buffer->clear(section.startSample + fade, numSamples - fade);
+        return;
+    }
+
+    // Starting exactly at the requested sample of the block
+    armedStartOffset = -1;
+    armed = false;
+    const int silent = jmax(0, offset - start);
+    bufferToFill.buffer->clear(section.startSample, silent);
+    renderAudible(AudioSourceChannelInfo(bufferToFill.buffer, section.startSample + silent, numSamples - silent));
+}
+
+void DJAudioPlayer::renderAudible(const AudioSourceChannelInfo& section)
+{
+    renderBlock(section);
+
+    // Fading in after a hold, so a start from a controller or the message thread does not click
+    if (heldSilent) {
+        heldSilent = false;
+        holdFadePosition = 0;
+    }
+    if (holdFadePosition < holdFadeSamples) {
+        const int fade = jmin(section.numSamples, holdFadeSamples - holdFadePosition);
+        section.buffer->applyGainRamp(section.startSample, fade,
+                                      holdFadePosition / (float) holdFadeSamples,
+                                      (holdFadePosition + fade) / (float) holdFadeSamples);
+        holdFadePosition += fade;
+    }
+}
+
+void DJAudioPlayer::queueCommand(const DeckCommand& command, int sampleOffset)
+{
+    if (numQueuedCommands == maxQueuedCommands) {
+        applyCommand(command);
+        return;
+    }
+    queuedCommands[numQueuedCommands++] = { command, sampleOffset };
+}
+
+void DJAudioPlayer::applyCommand(const DeckCommand& command)
+{
+    switch (command.type)
+    {
+        case DeckCommand::playPause:
+            // Pausing holds the deck the same way as an armed start, so playing again carries on from the same sample.
+            // Playing only lets go of the hold, the transport was left running by every stop so nothing is started
+            // here. A transport that stopped by itself at the end of the track stays stopped until it is moved
+            if (isPlaying()) {
+                armedStartOffset = -1;
+                armed = true;
+            }
+            else if (transportSource.isPlaying()) {
+                armedStartOffset = -1;
+                armed = false;
+            }
+            break;
+
+        case DeckCommand::pause:
+            if (isPlaying()) {
+                armedStartOffset = -1;
+                armed = true;
+            }
+            break;
+
+        case DeckCommand::gain:
+            transportSource.setGain(jlimit(0.0f, 1.0f, command.value));
+            break;
+
+        case DeckCommand::speed:
+            speed = jlimit(0.01, 100.0, (double) command.value);
+            break;
+
+        case DeckCommand::jog:
+            jogBend = jlimit(-0.9, 0.9, jogBend + command.value * jogBendPerTick);
+            break;
+
+        case DeckCommand::hotCue:
+        {
+            // A cue is not jumped to while scrubbing, the scrub is only ended on the message thread
+            const int index = (int) command.value;
+            if (scrubbing || getHotCue(index) < 0 || !transportSource.isPlaying()) {
+                break;
+            }
+
+            // A controller pad has no release, so in slip mode the cue plays its buffer and then goes back
+            const bool slip = slipMode && isPlaying();
+            if (slip && slipPosition < 0) {
+                slipPosition = hotCuePlayer.getCurrentPosition();
+            }
+            armedStartOffset = -1;
+            armed = false;
+            hotCuePlayer.trigger(index, slip);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void DJAudioPlayer::publishSnapshot(float peakLeft, float peakRight)
+{
+    auto& snapshot = snapshots.getWriteBuffer();
+    snapshot.position = getCurrentPosition();
+    snapshot.length = lengthInSeconds.load();
+    snapshot.speed = speed.load();
+    snapshot.gain = transportSource.getGain();
+    snapshot.playing = isPlaying();
+    snapshot.looping = looping.load();
+    snapshot.scrubbing = scrubbing.load();
+    snapshot.peakLeft = peakLeft;
+    snapshot.peakRight = peakRight;
+    snapshot.slipPosition = slipPosition;
+
+    snapshots.publish();
+}
+
+void DJAudioPlayer::updateSlip()
+{
+    // Stopping the deck or turning slip mode off leaves playback where it is
+    if (!slipMode || !isPlaying()) {
+        slipPosition = -1.0;
+        slipReturnRequested = false;
+        return;
+    }
+
+    const bool cueHeld = hotCuePlayer.isHoldingTransport() || hotCuePlayer.isHoldPending();
+    if (slipPosition < 0) {
+        if (!scrubbing && !cueHeld) {
+            slipReturnRequested = false;
+            return;
+        }
+
+        // The scrub and the cue both start at a block boundary, and neither has moved the transport yet
+        slipPosition = hotCuePlayer.getCurrentPosition();
+        parkedPosition = slipPosition;
+    }
+
+    // Going back once the scrub has ended or the pad was let go, with one exact seek. The transport is within a
+    // quarter of the read-ahead of the shadow, so the audio is already buffered and nothing is decoded on the
+    // audio thread. A held cue makes the seek itself as it crossfades back
+    if (slipReturnRequested && !scrubbing && !hotCuePlayer.isHoldPending()) {
+        slipReturnRequested = false;
+        if (hotCuePlayer.isHoldingTransport()) {
+            hotCuePlayer.release();
+        }
+        else {
+            hotCuePlayer.seekFromAudioThread(slipPosition);
+        }
+        slipPosition = -1.0;
+        return;
+    }
+
+    // A held cue that ran out has gone back to the transport by itself, moving it to the shadow as it did
+    if (!scrubbing && !cueHeld) {
+        slipPosition = -1.0;
+        return;
+    }
+
+    // The transport is not heard while the deck slips, so it is parked near the shadow in steps of a quarter of
+    // the read-ahead, and the read-ahead reads on from what it has, as it would while playing
+    if (std::abs(slipPosition - parkedPosition) * currentSampleRate > readAheadSamples / 4) {
+        hotCuePlayer.seekFromAudioThread(slipPosition);
+        parkedPosition = slipPosition;
+    }
+}
+
+void DJAudioPlayer::advanceSlip(int numSamples)
+{
+    if (slipPosition < 0) {
+        return;
+    }
+
+    slipPosition += numSamples * speed.load() / currentSampleRate;
+    const double length = lengthInSeconds.load();
+    if (length > 0 && slipPosition >= length) {
+        slipPosition = looping ? std::fmod(slipPosition, length) : length;
+    }
+}
+
+void DJAudioPlayer::renderBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    // While scrubbing the audio comes from the scrub window and the transport is left where it was
+    if (scrubbing) {
+        scrubEngine.getNextAudioBlock(bufferToFill);
+        bufferToFill.buffer->applyGain(bufferToFill.startSample, bufferToFill.numSamples, transportSource.getGain());
+        advanceSlip(bufferToFill.numSamples);
+        return;
+    }
+
+    // The speed is set here so the jog wheel can bend it on the audio thread
+    const double ratio = speed.load() * (1.0 + jogBend);
+    if (ratio != resampleSource.getResamplingRatio()) {
+        resampleSource.setResamplingRatio(ratio);
+    }
+
+    // A held cue that runs out in this block goes back to where the shadow is at its start
+    hotCuePlayer.setReturnPosition(slipPosition);
+    resampleSource.getNextAudioBlock(bufferToFill);
+    advanceSlip(bufferToFill.numSamples);
 }
 void DJAudioPlayer::releaseResources()
 {
@@ -40,18 +347,137 @@ void DJAudioPlayer::releaseResources()
     resampleSource.releaseResources();
 }
 
-void DJAudioPlayer::loadURL(URL audioURL)
+void DJAudioPlayer::loadURL(URL audioURL, AudioFormatReader* preloadedReader)
 {
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+    TraceSpan span("DJAudioPlayer::loadURL");
+
+    endScrub();
+
+    // Any stream still downloading its pre-buffer is replaced by this track
+    ++streamGeneration;
+    streamLoader.cancel();
+    startWhenLoaded = false;
+    loadingFile = false;
+
+    auto* reader = preloadedReader;
+    if (reader == nullptr) {
+        // Local files come from the shared decoder pool, and mp3s are opened with their seek index so seeking is exact.
+        // An mp3 whose index is not in memory yet is opened in the background, as the index may have to be built.
+        // Offline decks have no message loop to hand the reader back on, so they open it here
+        if (audioURL.isLocalFile()) {
+            if (useReadAhead && decoders->needsSeekIndex(audioURL.getLocalFile())) {
+                loadFile(audioURL);
+                return;
+            }
+            reader = decoders->createReaderFor(audioURL.getLocalFile());
+        }
+        else if (audioURL.getScheme().startsWithIgnoreCase("http")) {
+            if (!canStream(audioURL)) {
+                DBG("Streaming over https needs a build with JUCE_USE_CURL on Linux: " << audioURL.toString(false));
+                return;
+            }
+            loadStream(audioURL);
+            return;
+        }
+        else {
+            reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+        }
+    }
     if (reader != nullptr) // good file!
     {
         std::unique_ptr<AudioFormatReaderSource> newSource(new AudioFormatReaderSource(reader, true));
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
+        newSource->setLooping(looping);
+        transportSource.setSource(newSource.get(),
+                                  useReadAhead ? readAheadSamples : 0,
+                                  useReadAhead ? &readAheadThread : nullptr,
+                                  reader->sampleRate);
         readerSource.reset(newSource.release());
+        lengthInSeconds = transportSource.getLengthInSeconds();
+
+        // Setting the source stops the transport, so the new track is held with it running, without fading out its start
+        hold(false);
+
+        // The scrub engine and the hot cues read the track with their own readers so they never disturb playback
+        scrubEngine.setReader(createReaderFor(audioURL));
+        hotCuePlayer.setReader(createReaderFor(audioURL));
         DBG("File loaded");
     }
 }
 
+bool DJAudioPlayer::canStream(const URL& url)
+{
+    const String scheme = url.getScheme().toLowerCase();
+   #if JUCE_LINUX && ! JUCE_USE_CURL
+    // Without curl JUCE only speaks plain http on Linux
+    return scheme == "http";
+   #else
+    return scheme == "http" || scheme == "https";
+   #endif
+}
+
+void DJAudioPlayer::loadStream(URL audioURL)
+{
+    const int generation = streamGeneration;
+    WeakReference<DJAudioPlayer> self(this);
+
+    streamLoader.load(audioURL, streamPreBufferBytes, [self, generation, audioURL](std::unique_ptr<AudioFormatReader>& reader) {
+        // The deck may have gone, or loaded something else, while the stream was downloading
+        auto* player = self.get();
+        if (player == nullptr || player->streamGeneration != generation) {
+            return;
+        }
+
+        if (reader == nullptr) {
+            DBG("Could not stream " << audioURL.toString(false));
+            return;
+        }
+
+        // Decoding on the stream thread, so waiting on the network never holds up the read-ahead thread
+        if (!player->streamThread.isThreadRunning()) {
+            player->streamThread.startThread(Thread::Priority::normal);
+        }
+        const bool shouldStart = player->startWhenLoaded;
+        player->loadURL(audioURL, new BufferingAudioReader(reader.release(), player->streamThread, streamBufferSamples));
+        if (shouldStart) {
+            player->start();
+        }
+    });
+}
+
+void DJAudioPlayer::loadFile(URL audioURL)
+{
+    const int generation = streamGeneration;
+    WeakReference<DJAudioPlayer> self(this);
+    loadingFile = true;
+
+    fileLoader.addJob([self, generation, audioURL] {
+        TraceSpan span("DJAudioPlayer::loadFile");
+
+        SharedResourcePointer<DecoderService> decoders;
+        auto holder = std::make_shared<std::unique_ptr<AudioFormatReader>>(decoders->createReaderFor(audioURL.getLocalFile()));
+
+        // The deck may have gone, or loaded something else, while the track was being opened
+        MessageManager::callAsync([self, generation, audioURL, holder] {
+            auto* player = self.get();
+            if (player == nullptr || player->streamGeneration != generation) {
+                return;
+            }
+
+            player->loadingFile = false;
+            if (*holder == nullptr) {
+                DBG("Could not open " << audioURL.toString(false));
+                return;
+            }
+
+            const bool shouldStart = player->startWhenLoaded;
+            player->loadURL(audioURL, holder->release());
+            if (shouldStart) {
+                player->start();
+            }
+        });
+    });
+}
+
 void DJAudioPlayer::setGain(double gain)
 {
     if (gain < 0 || gain > 1.0)
@@ -71,12 +497,13 @@ void DJAudioPlayer::setSpeed(double ratio)
         std::cout << "DJAudioPlayer::setSpeed ratio should be between 0 and 100" << std::endl;
     }
     else {
-        resampleSource.setResamplingRatio(ratio);
+        speed = ratio;
     }
 }
 
 void DJAudioPlayer::setPosition(double posInSecs)
 {
+    hotCuePlayer.cancel();
     transportSource.setPosition(posInSecs);
 }
 
@@ -87,21 +514,220 @@ void DJAudioPlayer::setPositionRelative(double pos)
         std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1" << std::endl;
     }
     else {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
+        double posInSecs = lengthInSeconds.load() * pos;
         setPosition(posInSecs);
     }
 }
 
 void DJAudioPlayer::start()
 {
+    armed = false;
+    startWhenLoaded = streamLoader.isLoading() || loadingFile;
     transportSource.start();
+    wakeDisplays();
 }
 void DJAudioPlayer::stop()
 {
-    transportSource.stop();
+    hold(true);
+}
+
+void DJAudioPlayer::hold(bool fadeOut)
+{
+    // Stopping holds the deck with its transport running, like a pause from a controller, so a controller can
+    // start it again from the audio thread without calling into the transport. The audio thread fades the deck
+    // out as it is held and in as it is let go, and a held deck goes idle so its transport is no longer pulled
+    startWhenLoaded = false;
+    armedStartOffset = fadeOut ? -1 : heldWithoutFade;
+    armed = true;
+    transportSource.start();
+}
+
+void DJAudioPlayer::startScrub()
+{
+    if (!scrubbing && scrubEngine.canScrub()) {
+        scrubEngine.begin(getCurrentPosition());
+        scrubbing = true;
+        wakeDisplays();
+    }
+}
+
+void DJAudioPlayer::scrubToRelative(double pos)
+{
+    if (scrubbing) {
+        scrubEngine.setTargetPosition(lengthInSeconds.load() * jlimit(0.0, 1.0, pos));
+    }
+    else {
+        setPositionRelative(pos);
+    }
+}
+
+void DJAudioPlayer::endScrub()
+{
+    if (scrubbing) {
+        // In slip mode the audio thread takes the deck back to the shadow playhead once the scrub has stopped
+        const bool slip = slipMode && isPlaying();
+        if (slip) {
+            slipReturnRequested = true;
+        }
+        scrubbing = false;
+        scrubEngine.end();
+
+        // Only now is the decoder seeked, to where the scrub left the playhead
+        if (!slip) {
+            setPosition(scrubEngine.getPlayheadPosition());
+        }
+    }
+}
+
+bool DJAudioPlayer::isScrubbing() const
+{
+    return scrubbing;
+}
+
+void DJAudioPlayer::setHotCue(int index, double posInSecs)
+{
+    hotCuePlayer.setCue(index, posInSecs);
+}
+
+double DJAudioPlayer::getHotCue(int index) const
+{
+    return hotCuePlayer.getCue(index);
+}
+
+void DJAudioPlayer::triggerHotCue(int index)
+{
+    if (getHotCue(index) < 0) {
+        return;
+    }
+
+    endScrub();
+
+    // The transport is started first so the cue buffer is followed by the transport when it runs out
+    const bool slip = slipMode && isPlaying();
+    armedStartOffset = -1;
+    armed = false;
+    transportSource.start();
+    hotCuePlayer.trigger(index, slip);
+    wakeDisplays();
+}
+
+void DJAudioPlayer::releaseHotCue()
+{
+    if (slipMode) {
+        slipReturnRequested = true;
+    }
+}
+
+void DJAudioPlayer::setSlipMode(bool shouldSlip)
+{
+    slipMode = shouldSlip;
+}
+
+bool DJAudioPlayer::isSlipMode() const
+{
+    return slipMode;
+}
+
+double DJAudioPlayer::getCurrentPosition() const
+{
+    if (scrubbing) {
+        return scrubEngine.getPlayheadPosition();
+    }
+    return hotCuePlayer.getCurrentPosition();
+}
+
+double DJAudioPlayer::getRemainingSeconds() const
+{
+    double ratio = resampleSource.getResamplingRatio();
+    if (ratio <= 0) {
+        return std::numeric_limits<double>::max();
+    }
+    // The length is read from the atomic, as the auto DJ asks on the audio thread and the transport would lock
+    return jmax(0.0, lengthInSeconds.load() - getCurrentPosition()) / ratio;
+}
+
+bool DJAudioPlayer::isPlaying() const
+{
+    return transportSource.isPlaying() && !armed;
+}
+
+void DJAudioPlayer::armStart()
+{
+    armedStartOffset = -1;
+    armed = true;
+    transportSource.start();
+}
+
+void DJAudioPlayer::releaseArmedStart(int sampleOffset)
+{
+    armedStartOffset = jmax(0, sampleOffset);
+}
+
+void DJAudioPlayer::wakeDisplays()
+{
+    triggerAsyncUpdate();
+}
+
+void DJAudioPlayer::handleAsyncUpdate()
+{
+    if (onWake) {
+        onWake();
+    }
+}
+
+bool DJAudioPlayer::isArmed() const
+{
+    return armed;
+}
+
+void DJAudioPlayer::setMixGain(float gain)
+{
+    mixGain = jlimit(0.0f, 1.0f, gain);
 }
 
 double DJAudioPlayer::getPositionRelative()
 {
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
+    return getCurrentPosition() / lengthInSeconds.load();
+}
+
+void DJAudioPlayer::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+    if (readerSource != nullptr) {
+        readerSource->setLooping(shouldLoop);
+    }
+}
+
+const DJAudioPlayer::Snapshot& DJAudioPlayer::getSnapshot()
+{
+    return snapshots.read();
+}
+
+AudioAnalyser& DJAudioPlayer::getAnalyser()
+{
+    return analyser;
+}
+
+void DJAudioPlayer::setMonitor(AudioCallbackMonitor* monitorToUse, int section)
+{
+    monitor = monitorToUse;
+    monitorSection = section;
+}
+
+void DJAudioPlayer::setStreamPreBuffer(int64 numBytes)
+{
+    streamPreBufferBytes = jmax((int64) 0, numBytes);
+}
+
+bool DJAudioPlayer::isLoadingStream() const
+{
+    return streamLoader.isLoading();
+}
+
+AudioFormatReader* DJAudioPlayer::createReaderFor(URL audioURL)
+{
+    if (audioURL.isLocalFile()) {
+        return decoders->createReaderFor(audioURL.getLocalFile());
+    }
+    return nullptr;
 }
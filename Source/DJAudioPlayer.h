@@ -11,22 +11,54 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "ScrubEngine.h"
+#include "HotCuePlayer.h"
+#include "AudioCallbackMonitor.h"
+#include "HttpStream.h"
+#include "DecoderService.h"
+#include "TripleBuffer.h"
+#include "AudioAnalyser.h"
+#include "DeckCommand.h"
 
 //==============================================================================
 /*
 */
-class DJAudioPlayer  : public juce::Component,
-                       public AudioSource
+class DJAudioPlayer  : public AudioSource,
+                       private AsyncUpdater
 {
 public:
-    DJAudioPlayer(AudioFormatManager& _formatManager);
+    // What the deck was doing at the end of an audio block
+    struct Snapshot
+    {
+        double position = 0;
+        double length = 0;
+        double speed = 1.0;
+        float gain = 1.0f;
+        bool playing = false;
+        bool looping = false;
+        bool scrubbing = false;
+        float peakLeft = 0.0f;
+        float peakRight = 0.0f;
+
+        // Where the track would be without the scrub or held cue, negative when the deck is not slipping
+        double slipPosition = -1.0;
+    };
+
+    /** useReadAheadThread can be turned off so that tracks are decoded in the render call, for offline use.
+        Such a deck also opens every track in loadURL, as offline tools have no message loop to finish a load on */
+    DJAudioPlayer(AudioFormatManager& _formatManager, bool useReadAheadThread = true);
     ~DJAudioPlayer();
 
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
     void releaseResources() override;
 
-    void loadURL(URL audioURL);
+    /** load a track, using a reader that has already been opened for it when one is given */
+    void loadURL(URL audioURL, AudioFormatReader* preloadedReader = nullptr);
+
+    /** true if a remote URL can be streamed by this build, https needs JUCE's curl support on Linux */
+    static bool canStream(const URL& url);
+
     void setGain(double gain);
     void setSpeed(double ratio);
     void setPosition(double posInSecs);
@@ -36,13 +68,207 @@ public:
     void start();
     void stop();
 
+    /** start scrubbing from the current position, the decoder is not seeked until scrubbing ends */
+    void startScrub();
+    /** move the scrub target to a relative position */
+    void scrubToRelative(double pos);
+    /** stop scrubbing and carry on playing from where the scrub left the playhead */
+    void endScrub();
+    bool isScrubbing() const;
+
+    /** set a hot cue in seconds, or clear it with a negative position */
+    void setHotCue(int index, double posInSecs);
+    /** get a hot cue in seconds, negative when it is not set */
+    double getHotCue(int index) const;
+    /** jump to a hot cue from its pre-decoded buffer and play from there, in slip mode the cue is held */
+    void triggerHotCue(int index);
+    /** let go of a hot cue, in slip mode the deck goes back to where the track would have been */
+    void releaseHotCue();
+
+    /** in slip mode a scrub or a hot cue only lasts while it is held, then playback carries on from where
+        the track would have been if it had played on */
+    void setSlipMode(bool shouldSlip);
+    bool isSlipMode() const;
+
+    /** get the position of the playhead in seconds */
+    double getCurrentPosition() const;
+
+    /** get the seconds of output left before the end of the track at the current speed */
+    double getRemainingSeconds() const;
+    bool isPlaying() const;
+
+    /** start the transport but keep the deck silent and still until releaseArmedStart is called */
+    void armStart();
+    /** called on the audio thread to start an armed deck a number of samples into the next block */
+    void releaseArmedStart(int sampleOffset);
+    bool isArmed() const;
+
+    /** set a gain applied on top of the deck's own gain and ramped over a block, used for crossfades */
+    void setMixGain(float gain);
+
+    /** apply a command from a controller a number of samples into the next block, called on the audio thread before the block */
+    void queueCommand(const DeckCommand& command, int sampleOffset);
+
+    /** true once the deck has been stopped for a couple of blocks with nothing queued, called on the audio thread */
+    bool isIdle() const;
+    /** stand in for a block of an idle deck that was not rendered, called on the audio thread */
+    void skipBlock();
+
+    /** play the track again from the start when it reaches the end */
+    void setLooping(bool shouldLoop);
+
+    /** get the snapshot the audio thread published last, read once per frame by the deck's display */
+    const Snapshot& getSnapshot();
+
+    /** get the levels and spectrum of the deck's output */
+    AudioAnalyser& getAnalyser();
+
     /** get the relative position of the playhead */
     double getPositionRelative();
 
+    /** called on the message thread when the deck may start moving or making sound, so the displays that went
+        idle while it was stopped start updating again */
+    std::function<void()> onWake;
+
+    /** ask for onWake to be called, from any thread but the audio thread. The MIDI router calls it for every
+        command it sends the deck, and the auto DJ once it has started the deck */
+    void wakeDisplays();
+
+    /** time every render of this deck under a section of the monitor, set before the audio starts */
+    void setMonitor(AudioCallbackMonitor* monitorToUse, int section);
+
+    /** set how many bytes of an HTTP stream are downloaded before it is loaded */
+    void setStreamPreBuffer(int64 numBytes);
+    /** true while an HTTP stream is downloading its pre-buffer, start() then plays once it is loaded */
+    bool isLoadingStream() const;
+
 private:
+    // Function to open another reader for the loaded track, used by the scrub engine and the hot cues
+    AudioFormatReader* createReaderFor(URL audioURL);
+
+    // Function to render a block from the scrub engine or the transport
+    void renderBlock(const AudioSourceChannelInfo& bufferToFill);
+
+    // Function to render part of a block, keeping an armed deck silent until the sample it is released on
+    void renderSection(const AudioSourceChannelInfo& bufferToFill, int start, int numSamples);
+
+    // Function to render part of a block the deck is heard in, fading it in after a hold
+    void renderAudible(const AudioSourceChannelInfo& section);
+
+    // Function to hold the deck with its transport running, fading it out on the audio thread if it was heard
+    void hold(bool fadeOut);
+
+    // Function to apply a queued controller command on the audio thread
+    void applyCommand(const DeckCommand& command);
+
+    // Function to publish what the deck is doing after a block, called on the audio thread
+    void publishSnapshot(float peakLeft, float peakRight);
+
+    // Function to start, end or keep up the shadow playhead at the start of a block, called on the audio thread
+    void updateSlip();
+
+    // Function to move the shadow playhead on by the samples just rendered, at the deck's speed without the jog bend
+    void advanceSlip(int numSamples);
+
+    // Function to check whether the deck can only output silence, stopped or held by a pause from a controller
+    bool isSilent() const;
+
+    // Function to open an HTTP stream in the background, loading it once its pre-buffer is in
+    void loadStream(URL audioURL);
+
+    // Function to open a local track on the loader thread, used when its mp3 seek index has to be loaded or built
+    void loadFile(URL audioURL);
+
+    void handleAsyncUpdate() override;
+
+    // Samples the transport reads ahead of the playhead on the read-ahead thread
+    static constexpr int readAheadSamples = 32768;
+
+    // Commands a deck can be given for one block, any more are applied at its start
+    static constexpr int maxQueuedCommands = 64;
+
+    // How far one tick of a jog wheel bends the speed, and how quickly the bend falls back
+    static constexpr double jogBendPerTick = 0.02;
+    static constexpr double jogReleaseSeconds = 0.1;
+
+    // Samples a deck is faded over as it is held and let go, so a stop or a start never clicks
+    static constexpr int holdFadeSamples = 256;
+
+    // The armed start offset of a hold that starts silent, used when a track is loaded so its start is not faded out
+    static constexpr int heldWithoutFade = -2;
+
+    // Silent blocks rendered before the deck goes idle, so the transport's fade out and the resampler have finished
+    static constexpr int blocksBeforeIdle = 2;
+
+    // Samples decoded ahead from an HTTP stream, so a slow download plays silence instead of blocking the transport
+    static constexpr int streamBufferSamples = 10 * 44100;
+
     AudioFormatManager& formatManager;
+    SharedResourcePointer<DecoderService> decoders;
+    bool useReadAhead;
+    TimeSliceThread readAheadThread{ "Deck read-ahead" };
+    TimeSliceThread streamThread{ "Deck stream" };
     std::unique_ptr<AudioFormatReaderSource> readerSource;
     AudioTransportSource transportSource;
-    ResamplingAudioSource resampleSource{ &transportSource, false, 2 };
+    HotCuePlayer hotCuePlayer{ transportSource, readAheadThread };
+    ResamplingAudioSource resampleSource{ &hotCuePlayer, false, 2 };
+
+    ScrubEngine scrubEngine;
+    std::atomic<bool> scrubbing{ false };
+
+    // Set by the message thread, the audio thread starts and ends the slip itself
+    std::atomic<bool> slipMode{ false };
+    std::atomic<bool> slipReturnRequested{ false };
+
+    std::atomic<bool> armed{ false };
+    std::atomic<int> armedStartOffset{ -1 };
+
+    std::atomic<float> mixGain{ 1.0f };
+    float lastMixGain = 1.0f;
+
+    // The speed set on the deck, which the audio thread bends while the jog wheel is turning
+    std::atomic<double> speed{ 1.0 };
+
+    // Only touched by the audio thread
+    struct QueuedCommand
+    {
+        DeckCommand command;
+        int sampleOffset = 0;
+    };
+    QueuedCommand queuedCommands[maxQueuedCommands];
+    int numQueuedCommands = 0;
+    double jogBend = 0;
+    double currentSampleRate = 44100;
+    int silentBlocks = 0;
+
+    // Whether the deck is held silent, and how far the fade in after the last hold has got
+    bool heldSilent = true;
+    int holdFadePosition = holdFadeSamples;
+
+    // The shadow playhead in seconds, only ever moved by arithmetic, negative when the deck is not slipping
+    double slipPosition = -1.0;
+
+    // Where the transport was last parked while slipping, so it only follows the shadow in steps
+    double parkedPosition = 0.0;
+
+    // Kept here so the audio thread never has to lock the transport to read them
+    std::atomic<double> lengthInSeconds{ 0.0 };
+    std::atomic<bool> looping{ false };
+    TripleBuffer<Snapshot> snapshots;
+    AudioAnalyser analyser;
+
+    AudioCallbackMonitor* monitor = nullptr;
+    int monitorSection = 0;
+
+    HttpStreamLoader streamLoader{ formatManager };
+    int64 streamPreBufferBytes = 256 * 1024;
+    int streamGeneration = 0;
+    bool startWhenLoaded = false;
+    bool loadingFile = false;
+
+    // Opens tracks whose seek index is not in memory yet, so the message thread never walks an mp3's frames
+    ThreadPool fileLoader{ 1 };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (DJAudioPlayer)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DJAudioPlayer)
 };
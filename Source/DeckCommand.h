@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    DeckCommand.h
+    Created: 20 Oct 2026 6:12:40pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    One change to a deck from a controller, small enough to be copied through
+    a lock-free FIFO to the audio thread.
+*/
+struct DeckCommand
+{
+    enum Type
+    {
+        none,
+        playPause,
+        pause,
+        gain,       // value is the gain, from 0 to 1
+        speed,      // value is the speed ratio
+        jog,        // value is how many ticks the jog wheel moved, negative backwards
+        hotCue,     // value is the index of the cue
+        numTypes
+    };
+
+    int deck = 0;
+    Type type = none;
+    float value = 0.0f;
+
+    // When the message arrived, in seconds on the Time::getMillisecondCounterHiRes clock
+    double timestamp = 0;
+
+    /** get the name of a type, used in the mapping file and in menus */
+    static String getTypeName(Type type)
+    {
+        switch (type)
+        {
+            case playPause: return "Play/Pause";
+            case pause:     return "Pause";
+            case gain:      return "Gain";
+            case speed:     return "Speed";
+            case jog:       return "Jog";
+            case hotCue:    return "Hot Cue";
+            default:        return {};
+        }
+    }
+};
@@ -10,20 +10,30 @@
 
 #include <JuceHeader.h>
 #include "DeckGUI.h"
+#include "BinaryData.h"
+#include "Tracer.h"
 
 //==============================================================================
 DeckGUI::DeckGUI(DJAudioPlayer* _player,
                  AudioFormatManager& formatManagerToUse,
-                 AudioThumbnailCache& cacheToUse
+                 AudioThumbnailCache& cacheToUse,
+                 HotCueLibrary& hotCueLibraryToUse,
+                 MidiRouter& midiRouterToUse,
+                 int deckIndex
                 ) : player(_player),
-                    waveformDisplay(formatManagerToUse, cacheToUse)
+                    waveformDisplay(formatManagerToUse, cacheToUse),
+                    analyserDisplay(_player->getAnalyser()),
+                    hotCueLibrary(hotCueLibraryToUse),
+                    midiRouter(midiRouterToUse),
+                    deck(deckIndex)
 {
-    // Getting the Image from JUCE binary data and assigning it to a JUCE Image
-    Image playImage = ImageFileFormat::loadFrom(BinaryData::play_png, BinaryData::play_pngSize);
-    Image pauseImage = ImageFileFormat::loadFrom(BinaryData::pause_png, BinaryData::pause_pngSize);
-    Image restartImage = ImageFileFormat::loadFrom(BinaryData::restart_png, BinaryData::restart_pngSize);
-    Image stopImage = ImageFileFormat::loadFrom(BinaryData::stop_png, BinaryData::stop_pngSize);
-    Image loadImage = ImageFileFormat::loadFrom(BinaryData::load_png, BinaryData::load_pngSize);
+    // Getting the Image from JUCE binary data through the image cache, so each PNG is only decoded once and
+    // both decks share the same images
+    Image playImage = ImageCache::getFromMemory(BinaryData::play_png, BinaryData::play_pngSize);
+    Image pauseImage = ImageCache::getFromMemory(BinaryData::pause_png, BinaryData::pause_pngSize);
+    Image restartImage = ImageCache::getFromMemory(BinaryData::restart_png, BinaryData::restart_pngSize);
+    Image stopImage = ImageCache::getFromMemory(BinaryData::stop_png, BinaryData::stop_pngSize);
+    Image loadImage = ImageCache::getFromMemory(BinaryData::load_png, BinaryData::load_pngSize);
 
     // Setting the images of the image buttons
     playButton.setImages(true, true, true, playImage, 0.7f, juce::Colours::transparentBlack, 
@@ -42,16 +52,42 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     addAndMakeVisible(pauseButton);
     addAndMakeVisible(restartButton);
     addAndMakeVisible(loopButton);
+    addAndMakeVisible(slipButton);
     addAndMakeVisible(stopButton);
     addAndMakeVisible(loadButton);
 
+    // Hot cue buttons
+    for (int i = 0; i < HotCuePlayer::numHotCues; ++i) {
+        auto* cueButton = cueButtons.add(new TextButton(String(i + 1)));
+        cueButton->setTooltip("Hot cue " + String(i + 1) + ", shift-click to clear");
+
+        // Pads fire as they are pressed, and in slip mode the deck goes back when they are let go
+        cueButton->setTriggeredOnMouseDown(true);
+        cueButton->onClick = [this, i] { hotCueClicked(i); };
+        cueButton->onStateChange = [this, i, cueButton] {
+            if (heldCue == i && !cueButton->isDown()) {
+                heldCue = -1;
+                player->releaseHotCue();
+            }
+        };
+        addAndMakeVisible(cueButton);
+    }
+    updateHotCues();
+
+    // MIDI learn button
+    midiButton.setTooltip("Map a MIDI controller to this deck");
+    midiButton.setColour(TextButton::buttonOnColourId, Colours::orange);
+    midiButton.onClick = [this] { showMidiMenu(); };
+    addAndMakeVisible(midiButton);
+
     // Sliders
     addAndMakeVisible(volSlider);
     addAndMakeVisible(speedSlider);
     addAndMakeVisible(posSlider);
 
-    // Waveform
+    // Waveform, with the deck's meters and spectrum next to it
     addAndMakeVisible(waveformDisplay);
+    addAndMakeVisible(analyserDisplay);
 
     // Slider Labels
     addAndMakeVisible(volumeLabel);
@@ -81,6 +117,7 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     pauseButton.addListener(this);
     restartButton.addListener(this);
     loopButton.addListener(this);
+    slipButton.addListener(this);
     stopButton.addListener(this);
     loadButton.addListener(this);
 
@@ -110,12 +147,11 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     speedSlider.setLookAndFeel(&otherLookAndFeel);
     posSlider.setLookAndFeel(&otherLookAndFeel);
 
-    startTimer(500);
+    setIdle(false);
 }
 
 DeckGUI::~DeckGUI()
 {
-    stopTimer();
 }
 
 void DeckGUI::paint (juce::Graphics& g)
@@ -142,20 +178,34 @@ void DeckGUI::resized()
     pauseButton.setBounds(rowW * 2, 0, rowW, rowH);
     stopButton.setBounds(rowW * 3, rowH * 0.05, rowW, rowH * 0.9);
     restartButton.setBounds(rowW * 4, 0, rowW, rowH);
-    loopButton.setBounds(rowW * 5, 0, rowW, rowH);
+    loopButton.setBounds(rowW * 5, 0, rowW, rowH / 2);
+    slipButton.setBounds(rowW * 5, rowH / 2, rowW, rowH / 2);
 
     // Bounds setting for the sliders
-    volSlider.setBounds(0, rowH * 1.4, sliderW, rowH * 1.5);
-    speedSlider.setBounds(sliderW, rowH * 1.4, sliderW, rowH * 1.5);
-    posSlider.setBounds(sliderW * 2, rowH * 1.4, sliderW, rowH * 1.5);
+    volSlider.setBounds(0, rowH * 1.4, sliderW, rowH * 1.35);
+    speedSlider.setBounds(sliderW, rowH * 1.4, sliderW, rowH * 1.35);
+    posSlider.setBounds(sliderW * 2, rowH * 1.4, sliderW, rowH * 1.35);
+
+    // Bounds setting for the hot cue buttons
+    double cueW = (double) getWidth() / cueButtons.size();
+    for (int i = 0; i < cueButtons.size(); ++i) {
+        cueButtons[i]->setBounds(cueW * i + 2, rowH * 2.8, cueW - 4, rowH * 0.4);
+    }
+
+    // Bounds setting for the MIDI button, at the right of the track title
+    midiButton.setBounds(getWidth() - 54, rowH * 3.25, 50, rowH * 0.3);
 
-    // Bounds setting for waveform display
-    waveformDisplay.setBounds(0, rowH * 3.4, getWidth(), rowH * 1.6);
+    // Bounds setting for waveform display and the analyser beside it
+    waveformDisplay.setBounds(0, rowH * 3.6, getWidth() * 0.75, rowH * 1.4);
+    analyserDisplay.setBounds(getWidth() * 0.75, rowH * 3.6, getWidth() * 0.25, rowH * 1.4);
     
 }
 
 void DeckGUI::buttonClicked(Button* button)
 {
+    // Anything done to the deck brings back the per-frame updates straight away
+    setIdle(false);
+
     // Play Button
     if (button == &playButton)
     {
@@ -176,6 +226,16 @@ void DeckGUI::buttonClicked(Button* button)
         player->setPosition(0);
     }
 
+    // Loop Button, the player loops the track itself so the end is never missed
+    if (button == &loopButton) {
+        player->setLooping(loopButton.getToggleState());
+    }
+
+    // Slip Button, scrubs and held cues then go back to where the track would have been
+    if (button == &slipButton) {
+        player->setSlipMode(slipButton.getToggleState());
+    }
+
     // Stop Button
     if (button == &stopButton) {
         player->stop();
@@ -187,15 +247,15 @@ void DeckGUI::buttonClicked(Button* button)
         auto fileChooserFlags = FileBrowserComponent::canSelectFiles;
         fChooser.launchAsync(fileChooserFlags, [this](const FileChooser& chooser) {
             URL track = URL(chooser.getResult());
-            player->loadURL(track);
-            waveformDisplay.loadURL(track);
-            titleLabel.setText("Now Playing: " + track.getFileName(), dontSendNotification);
+            play(track);
         });
     }
 }
 
 void DeckGUI::sliderValueChanged(Slider* slider)
 {
+    setIdle(false);
+
     // Volume Slider
     if (slider == &volSlider)
     {
@@ -208,31 +268,130 @@ void DeckGUI::sliderValueChanged(Slider* slider)
         player->setSpeed(slider->getValue());
     }
 
-    // Position Slider
+    // Position Slider, which scrubs while it is being dragged
     if (slider == &posSlider)
     {
-        player->setPositionRelative(slider->getValue());
+        player->scrubToRelative(slider->getValue());
     }
 
 }
 
-void DeckGUI::timerCallback()
+void DeckGUI::sliderDragStarted(Slider* slider)
 {
+    setIdle(false);
+
+    if (slider == &posSlider)
+    {
+        player->startScrub();
+    }
+}
+
+void DeckGUI::sliderDragEnded(Slider* slider)
+{
+    if (slider == &posSlider)
+    {
+        player->endScrub();
+    }
+}
+
+void DeckGUI::updateFromSnapshot()
+{
+    // Reading the deck once per frame, from the snapshot the audio thread published last
+    const DJAudioPlayer::Snapshot& snapshot = player->getSnapshot();
+
     // Display the moving rectangle box on waveform display determined by the current position of the track
-    waveformDisplay.setPositionRelative(player->getPositionRelative());
+    if (snapshot.length > 0) {
+        waveformDisplay.setPositionRelative(jlimit(0.0, 1.0, snapshot.position / snapshot.length));
 
-    // Ensure that the track will be looped when it is finished
-    if (loopButton.getToggleState() == 1) {
-        if (player->getPositionRelative() >= 1) {
-            player->setPosition(0);
-            player->start();
-        }
+        // The shadow playhead is marked while the deck slips
+        const double slip = snapshot.slipPosition >= 0 ? jlimit(0.0, 1.0, snapshot.slipPosition / snapshot.length) : -1.0;
+        waveformDisplay.setSlipPositionRelative(slip);
+    }
+
+    // A controller can move the gain and speed on the audio thread, so the sliders follow the deck when they change
+    if (snapshot.gain != shownGain && !volSlider.isMouseButtonDown()) {
+        shownGain = snapshot.gain;
+        volSlider.setValue(shownGain, dontSendNotification);
+    }
+    if (snapshot.speed != shownSpeed && !speedSlider.isMouseButtonDown()) {
+        shownSpeed = snapshot.speed;
+        speedSlider.setValue(shownSpeed, dontSendNotification);
+    }
+
+    // The MIDI button lights up while it waits for a control to learn
+    const bool learning = midiRouter.isLearning(deck);
+    if (midiButton.getToggleState() != learning) {
+        midiButton.setToggleState(learning, dontSendNotification);
+    }
+
+    // A deck that has not moved for a second stops updating every frame
+    const bool moving = snapshot.playing || snapshot.scrubbing || learning || snapshot.position != shownPosition;
+    shownPosition = snapshot.position;
+    stoppedFrames = moving ? 0 : jmin(stoppedFrames + 1, framesBeforeIdle);
+    setIdle(stoppedFrames >= framesBeforeIdle);
+}
+
+void DeckGUI::setIdle(bool shouldBeIdle)
+{
+    if (shouldBeIdle == (vBlankAttachment == nullptr)) {
+        return;
+    }
+
+    if (shouldBeIdle) {
+        vBlankAttachment.reset();
     }
     else {
-        if (player->getPositionRelative() >= 1) {
-            player->stop();
+        stoppedFrames = 0;
+        vBlankAttachment = std::make_unique<VBlankAttachment>(this, [this] { updateFromSnapshot(); });
+
+        // The deck's meters come back with it, as it may be about to make sound
+        analyserDisplay.wake();
+    }
+}
+
+void DeckGUI::wake()
+{
+    setIdle(false);
+}
+
+void DeckGUI::showMidiMenu()
+{
+    setIdle(false);
+
+    if (midiRouter.isLearning(deck)) {
+        midiRouter.cancelLearning();
+        return;
+    }
+
+    // Every command the deck can be given, with the control mapped to it
+    struct Item { DeckCommand::Type type; int value; String name; };
+    Array<Item> items;
+    for (auto type : { DeckCommand::playPause, DeckCommand::pause, DeckCommand::gain, DeckCommand::speed, DeckCommand::jog }) {
+        items.add({ type, 0, DeckCommand::getTypeName(type) });
+    }
+    for (int i = 0; i < HotCuePlayer::numHotCues; ++i) {
+        items.add({ DeckCommand::hotCue, i, DeckCommand::getTypeName(DeckCommand::hotCue) + " " + String(i + 1) });
+    }
+
+    PopupMenu menu;
+    PopupMenu clearMenu;
+    menu.addSectionHeader("Learn, then move a control");
+    for (int i = 0; i < items.size(); ++i) {
+        const auto& item = items.getReference(i);
+        const String mapping = midiRouter.getMappingDescription(deck, item.type, item.value);
+        menu.addItem(item.name + (mapping.isNotEmpty() ? "  (" + mapping + ")" : String()), [this, item] {
+            midiRouter.startLearning(deck, item.type, item.value);
+        });
+        if (mapping.isNotEmpty()) {
+            clearMenu.addItem(item.name + "  (" + mapping + ")", [this, item] {
+                midiRouter.clearMapping(deck, item.type, item.value);
+            });
         }
     }
+
+    menu.addSeparator();
+    menu.addSubMenu("Clear", clearMenu, clearMenu.getNumItems() > 0);
+    menu.showMenuAsync(PopupMenu::Options().withTargetComponent(&midiButton));
 }
 
 bool DeckGUI::isInterestedInFileDrag(const StringArray& files)
@@ -249,15 +408,81 @@ void DeckGUI::filesDropped(const StringArray& files, int x, int y)
         File track = File(files[0]);
         URL trackURL = URL{ track };
         DBG(trackURL.toString(true));
-        player->loadURL(trackURL);
-        waveformDisplay.loadURL(trackURL);
+        play(trackURL);
     }
 }
 
-void DeckGUI::play(URL track)
+bool DeckGUI::isInterestedInTextDrag(const String& text)
+{
+    const String link = text.trim();
+    return (link.startsWithIgnoreCase("http://") || link.startsWithIgnoreCase("https://")) && DJAudioPlayer::canStream(URL(link));
+}
+
+void DeckGUI::textDropped(const String& text, int x, int y)
 {
-    player->loadURL(track);
+    play(URL(text.trim()));
+}
+
+void DeckGUI::play(URL track, AudioFormatReader* preloadedReader)
+{
+    TraceSpan span("DeckGUI::play");
+
+    setIdle(false);
+
+    player->loadURL(track, preloadedReader);
     waveformDisplay.loadURL(track);
     // Setting the text to appear when a song is loaded
     titleLabel.setText("Now Playing: " + track.getFileName(), dontSendNotification);
+
+    // Giving the player the hot cues saved for this track so their buffers are decoded straight away
+    loadedTrack = track.isLocalFile() ? track.getLocalFile() : File();
+    Array<double> cues = hotCueLibrary.getCues(loadedTrack);
+    for (int i = 0; i < HotCuePlayer::numHotCues; ++i) {
+        player->setHotCue(i, loadedTrack.existsAsFile() ? cues[i] : -1.0);
+    }
+    updateHotCues();
+
+    if (onTrackLoaded != nullptr) {
+        onTrackLoaded();
+    }
+}
+
+File DeckGUI::getLoadedTrack() const
+{
+    return loadedTrack;
+}
+
+void DeckGUI::hotCueClicked(int index)
+{
+    setIdle(false);
+
+    if (ModifierKeys::getCurrentModifiers().isShiftDown()) {
+        // Clearing the cue
+        player->setHotCue(index, -1.0);
+        hotCueLibrary.setCue(loadedTrack, index, -1.0);
+    }
+    else if (player->getHotCue(index) >= 0) {
+        player->triggerHotCue(index);
+        heldCue = index;
+    }
+    else if (loadedTrack.existsAsFile()) {
+        // Setting an empty cue at the playhead
+        double position = player->getCurrentPosition();
+        player->setHotCue(index, position);
+        hotCueLibrary.setCue(loadedTrack, index, position);
+    }
+    updateHotCues();
+}
+
+void DeckGUI::updateHotCues()
+{
+    Array<double> cuePositions;
+    for (int i = 0; i < cueButtons.size(); ++i) {
+        double cue = player->getHotCue(i);
+        cueButtons[i]->setColour(TextButton::buttonColourId, cue >= 0 ? Colours::orange : Colours::darkgrey);
+        if (cue >= 0) {
+            cuePositions.add(cue);
+        }
+    }
+    waveformDisplay.setCuePositions(cuePositions);
 }
\ No newline at end of file
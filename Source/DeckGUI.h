@@ -13,7 +13,10 @@
 #include <JuceHeader.h>
 #include "DJAudioPlayer.h"
 #include "WaveformDisplay.h"
+#include "AnalyserDisplay.h"
 #include "PlaylistComponent.h"
+#include "HotCueLibrary.h"
+#include "MidiRouter.h"
 
 //==============================================================================
 
@@ -53,13 +56,16 @@ public:
 class DeckGUI  : public Component,
                  public Button::Listener,
                  public Slider::Listener,
-                 public Timer,
-                 public FileDragAndDropTarget
+                 public FileDragAndDropTarget,
+                 public TextDragAndDropTarget
 {
 public:
     DeckGUI(DJAudioPlayer* player,
         AudioFormatManager& formatManagerToUse,
-        AudioThumbnailCache& cacheToUse);
+        AudioThumbnailCache& cacheToUse,
+        HotCueLibrary& hotCueLibraryToUse,
+        MidiRouter& midiRouterToUse,
+        int deckIndex);
     ~DeckGUI();
 
     void paint(Graphics&) override;
@@ -70,16 +76,44 @@ public:
 
     /** implement Slider::Listener */
     void sliderValueChanged(Slider* slider) override;
-
-    void timerCallback() override;
+    void sliderDragStarted(Slider* slider) override;
+    void sliderDragEnded(Slider* slider) override;
 
     bool isInterestedInFileDrag(const StringArray& files) override;
     void filesDropped(const StringArray& files, int x, int y) override;
 
-    // function to play the track and display its waveform
-    void play(URL track);
+    /** links dropped from a browser are streamed over HTTP, https only where the build supports it */
+    bool isInterestedInTextDrag(const String& text) override;
+    void textDropped(const String& text, int x, int y) override;
+
+    // function to play the track and display its waveform, preloadedReader is used when it is given
+    void play(URL track, AudioFormatReader* preloadedReader = nullptr);
+
+    // Function to get the local file loaded on the deck, or File() for a stream or an empty deck
+    File getLoadedTrack() const;
+
+    /** called on the message thread after a track is loaded, however it was chosen */
+    std::function<void()> onTrackLoaded;
+
+    /** start updating every frame again after the deck went idle, called when the player says it may be moving */
+    void wake();
 
 private:
+    // Function to trigger a hot cue, or set it at the playhead when it is empty, shift-click clears it
+    void hotCueClicked(int index);
+
+    // Function to update the cue buttons and the cue markers on the waveform
+    void updateHotCues();
+
+    // Function to show the deck's MIDI mappings, picking one learns it from the next control moved
+    void showMidiMenu();
+
+    // Function to draw the deck from the player's latest snapshot, called once per display frame
+    void updateFromSnapshot();
+
+    // Function to start or stop the per-frame updates, nothing is updated while the deck is idle
+    void setIdle(bool shouldBeIdle);
+
 
     // Image Buttons
     ImageButton playButton;
@@ -88,8 +122,15 @@ private:
     ImageButton stopButton;
     ImageButton loadButton;
 
-    // Toggle Button
+    // Toggle Buttons
     ToggleButton loopButton{ "LOOP" };
+    ToggleButton slipButton{ "SLIP" };
+
+    // Hot cue buttons
+    OwnedArray<TextButton> cueButtons;
+
+    // MIDI learn button
+    TextButton midiButton{ "MIDI" };
 
     // Now playing label
     Label titleLabel;
@@ -107,12 +148,34 @@ private:
     OtherLookAndFeel otherLookAndFeel;
 
     WaveformDisplay waveformDisplay;
+    AnalyserDisplay analyserDisplay;
 
     FileChooser fChooser{ "Select a file..." , File(), "*.mp3", true, false };
 
     DJAudioPlayer* player;
 
-    AudioFormatManager formatManager;
+    HotCueLibrary& hotCueLibrary;
+    File loadedTrack;
+
+    // The cue pad being held down, which lets the deck go back when it is released in slip mode
+    int heldCue = -1;
+
+    MidiRouter& midiRouter;
+    int deck;
+
+    // The gain and speed the sliders were last moved to from the deck's snapshot
+    float shownGain = -1.0f;
+    double shownSpeed = -1.0;
+
+    // The playhead in the last snapshot drawn
+    double shownPosition = -1.0;
+
+    // Frames the deck has been stopped for, it goes idle after a second of them
+    int stoppedFrames = 0;
+    static constexpr int framesBeforeIdle = 60;
+
+    // Calls updateFromSnapshot in time with the display's refresh, null while the deck is idle
+    std::unique_ptr<VBlankAttachment> vBlankAttachment;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckGUI)
 };
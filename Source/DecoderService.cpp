@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    DecoderService.cpp
+    Created: 20 Oct 2026 9:21:07am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DecoderService.h"
+#include "Mp3SeekIndex.h"
+
+//==============================================================================
+/*
+    The reader handed out by the service. It reads through the pooled reader
+    it borrowed, and gives it back when it is deleted.
+*/
+class DecoderService::PooledReader  : public AudioFormatReader
+{
+public:
+    PooledReader(Slot& slotToUse)
+        : AudioFormatReader(nullptr, slotToUse.reader->getFormatName()),
+          slot(slotToUse)
+    {
+        auto& source = *slot.reader;
+        sampleRate = source.sampleRate;
+        bitsPerSample = source.bitsPerSample;
+        lengthInSamples = source.lengthInSamples;
+        numChannels = source.numChannels;
+        usesFloatingPointData = source.usesFloatingPointData;
+        metadataValues = source.metadataValues;
+    }
+
+    ~PooledReader() override
+    {
+        service->release(&slot);
+    }
+
+    bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     int64 startSampleInFile, int numSamples) override
+    {
+        return slot.reader->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                        startSampleInFile, numSamples);
+    }
+
+private:
+    // Keeps the service alive for as long as one of its readers is
+    SharedResourcePointer<DecoderService> service;
+    Slot& slot;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PooledReader)
+};
+
+//==============================================================================
+DecoderService::DecoderService()
+{
+    formatManager.registerBasicFormats();
+}
+
+DecoderService::~DecoderService()
+{
+}
+
+AudioFormatManager& DecoderService::getFormatManager()
+{
+    return formatManager;
+}
+
+AudioFormatReader* DecoderService::createReaderFor(const File& track, bool seekable)
+{
+    // Only mp3s are opened differently for seeking, any other reader can be used for anything
+    seekable = seekable && track.hasFileExtension("mp3");
+
+    Slot* slot = nullptr;
+    Slot* slotToUpgrade = nullptr;
+
+    {
+        const ScopedLock sl(lock);
+
+        // Borrowing an unused reader for the track, a seekable one can be used for anything
+        for (auto* s : slots) {
+            if (!s->inUse && s->file == track) {
+                if (s->seekable || !seekable) {
+                    slot = s;
+                    break;
+                }
+                slotToUpgrade = s;
+            }
+        }
+
+        if (slot == nullptr) {
+            slot = slotToUpgrade;
+        }
+
+        if (slot != nullptr) {
+            slot->inUse = true;
+            slot->lastUsed = Time::getMillisecondCounter();
+
+            if (slot->seekable || !seekable) {
+                return new PooledReader(*slot);
+            }
+        }
+    }
+
+    // Opening a new reader outside the lock, as building a seek index can take a while
+    std::unique_ptr<AudioFormatReader> reader(seekable ? IndexedMp3Reader::createReaderFor(formatManager, track, getSeekIndex(track))
+                                                       : formatManager.createReaderFor(track));
+
+    const ScopedLock sl(lock);
+
+    if (slot != nullptr) {
+        // A reader opened by a probe is replaced with a seekable one, so the track stays open once
+        if (reader == nullptr) {
+            slot->inUse = false;
+            return nullptr;
+        }
+        slot->reader = std::move(reader);
+        slot->seekable = true;
+        return new PooledReader(*slot);
+    }
+
+    if (reader == nullptr) {
+        return nullptr;
+    }
+
+    slot = slots.add(new Slot());
+    slot->file = track;
+    slot->seekable = seekable;
+    slot->reader = std::move(reader);
+    slot->inUse = true;
+    slot->lastUsed = Time::getMillisecondCounter();
+
+    closeUnusedReaders();
+    return new PooledReader(*slot);
+}
+
+double DecoderService::getLengthInSeconds(const File& track)
+{
+    std::unique_ptr<AudioFormatReader> reader(createReaderFor(track, false));
+    if (reader == nullptr || reader->sampleRate <= 0) {
+        return 0;
+    }
+    return reader->lengthInSamples / reader->sampleRate;
+}
+
+bool DecoderService::needsSeekIndex(const File& track)
+{
+    if (!track.hasFileExtension("mp3")) {
+        return false;
+    }
+
+    const ScopedLock sl(lock);
+    auto it = seekIndexes.find(track.getFullPathName());
+    return it == seekIndexes.end() || !it->second->isUpToDate(track);
+}
+
+std::shared_ptr<const Mp3SeekIndex> DecoderService::getSeekIndex(const File& track)
+{
+    if (!track.hasFileExtension("mp3")) {
+        return nullptr;
+    }
+
+    const String trackPath = track.getFullPathName();
+    {
+        const ScopedLock sl(lock);
+        auto it = seekIndexes.find(trackPath);
+        if (it != seekIndexes.end() && it->second->isUpToDate(track)) {
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<const Mp3SeekIndex> index(Mp3SeekIndex::loadOrBuild(track));
+    if (index == nullptr) {
+        return nullptr;
+    }
+
+    const ScopedLock sl(lock);
+
+    // Another reader may have loaded the same index while this one was
+    auto it = seekIndexes.find(trackPath);
+    if (it != seekIndexes.end() && it->second->isUpToDate(track)) {
+        return it->second;
+    }
+    seekIndexes[trackPath] = index;
+
+    for (auto unused = seekIndexes.begin(); unused != seekIndexes.end() && (int) seekIndexes.size() > maxCachedIndexes;) {
+        if (unused->second.use_count() == 1) {
+            unused = seekIndexes.erase(unused);
+        }
+        else {
+            ++unused;
+        }
+    }
+    return index;
+}
+
+void DecoderService::setMaxOpenReaders(int newMax)
+{
+    const ScopedLock sl(lock);
+    maxOpenReaders = jmax(1, newMax);
+    closeUnusedReaders();
+}
+
+int DecoderService::getNumOpenReaders() const
+{
+    const ScopedLock sl(lock);
+    return slots.size();
+}
+
+void DecoderService::release(Slot* slot)
+{
+    const ScopedLock sl(lock);
+    slot->inUse = false;
+    slot->lastUsed = Time::getMillisecondCounter();
+    closeUnusedReaders();
+}
+
+void DecoderService::closeUnusedReaders()
+{
+    while (slots.size() > maxOpenReaders)
+    {
+        // Closing the unused reader that has gone longest without being borrowed
+        int oldest = -1;
+        for (int i = 0; i < slots.size(); ++i) {
+            if (!slots[i]->inUse && (oldest < 0 || slots[i]->lastUsed < slots[oldest]->lastUsed)) {
+                oldest = i;
+            }
+        }
+
+        // Readers that are lent out cannot be closed, they are closed when they come back instead
+        if (oldest < 0) {
+            break;
+        }
+        slots.remove(oldest);
+    }
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    DecoderService.h
+    Created: 20 Oct 2026 9:21:07am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+
+class Mp3SeekIndex;
+
+//==============================================================================
+/*
+    The one place tracks are opened, shared by the whole application through
+    a SharedResourcePointer<DecoderService>.
+
+    It owns the registered formats, and keeps a pool of open readers for each
+    file. A reader handed out by createReaderFor borrows a pooled reader and
+    gives it back when it is deleted, so probing a track, warming it up and
+    then playing it reuses the same decoder instead of opening the file each
+    time. Readers that are not being used are closed, oldest first, once more
+    than the limit are open, which keeps large imports and long sessions from
+    piling up file handles.
+
+    The mp3 seek indexes are kept in memory too, one per file, and shared by
+    every seekable reader of it, so a track's index is only loaded or built
+    once however many readers it has.
+*/
+class DecoderService
+{
+public:
+    DecoderService();
+    ~DecoderService();
+
+    /** get the formats the application can read, for thumbnails and streams */
+    AudioFormatManager& getFormatManager();
+
+    /** open a reader for a track that the caller owns, or nullptr if it cannot be read. seekable mp3 readers use
+        the seek index, which is built the first time the track is seen, so probing asks for a plain reader instead.
+        An unused plain reader is swapped for a seekable one when the track is then played, instead of opening it twice */
+    AudioFormatReader* createReaderFor(const File& track, bool seekable = true);
+
+    /** get the length of a track in seconds, or 0 if it cannot be read */
+    double getLengthInSeconds(const File& track);
+
+    /** true when opening the track seekable would first load or build its mp3 seek index, which can take a
+        while, so the track should be opened on a background thread */
+    bool needsSeekIndex(const File& track);
+
+    /** set how many readers can be open before unused ones are closed */
+    void setMaxOpenReaders(int newMax);
+
+    /** get how many readers are open, both pooled and in use */
+    int getNumOpenReaders() const;
+
+private:
+    class PooledReader;
+
+    // A reader the pool has open, either waiting to be borrowed or lent out
+    struct Slot
+    {
+        File file;
+        bool seekable = false;
+        std::unique_ptr<AudioFormatReader> reader;
+        bool inUse = false;
+        uint32 lastUsed = 0;
+    };
+
+    // Function to give a borrowed reader back to the pool
+    void release(Slot* slot);
+
+    // Function to close unused readers while too many are open, called with the lock held
+    void closeUnusedReaders();
+
+    // Function to get the seek index of an mp3 from memory, loading or building it outside the lock when it is not
+    std::shared_ptr<const Mp3SeekIndex> getSeekIndex(const File& track);
+
+    // Indexes no reader is using are dropped once more than this many are kept
+    static constexpr int maxCachedIndexes = 32;
+
+    AudioFormatManager formatManager;
+
+    CriticalSection lock;
+    OwnedArray<Slot> slots;
+    int maxOpenReaders = 16;
+    std::map<String, std::shared_ptr<const Mp3SeekIndex>> seekIndexes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecoderService)
+};
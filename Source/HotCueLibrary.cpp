@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    HotCueLibrary.cpp
+    Created: 19 Oct 2026 2:30:51pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <fstream>
+#include "HotCueLibrary.h"
+
+//==============================================================================
+HotCueLibrary::HotCueLibrary()
+{
+    // Reading the cues saved before the application was closed
+    std::ifstream file("HotCues.txt");
+    std::string line;
+    while (std::getline(file, line)) {
+        StringArray fields = StringArray::fromTokens(String(line), "\t", "");
+        if (fields.size() != 3) {
+            continue;
+        }
+
+        const int index = fields[1].getIntValue();
+        if (index < 0 || index >= HotCuePlayer::numHotCues) {
+            continue;
+        }
+
+        auto& trackCues = cues[fields[0]];
+        while (trackCues.size() < HotCuePlayer::numHotCues) {
+            trackCues.add(-1.0);
+        }
+        trackCues.set(index, fields[2].getDoubleValue());
+    }
+}
+
+Array<double> HotCueLibrary::getCues(const File& track) const
+{
+    auto found = cues.find(track.getFullPathName());
+    if (found != cues.end()) {
+        return found->second;
+    }
+
+    Array<double> none;
+    while (none.size() < HotCuePlayer::numHotCues) {
+        none.add(-1.0);
+    }
+    return none;
+}
+
+void HotCueLibrary::setCue(const File& track, int index, double posInSecs)
+{
+    if (index < 0 || index >= HotCuePlayer::numHotCues) {
+        return;
+    }
+
+    auto trackCues = getCues(track);
+    trackCues.set(index, posInSecs);
+    cues[track.getFullPathName()] = trackCues;
+
+    updateFile();
+}
+
+void HotCueLibrary::updateFile() const
+{
+    // Writing to HotCues.txt
+    std::ofstream file("HotCues.txt");
+    for (auto& trackCues : cues) {
+        for (int i = 0; i < trackCues.second.size(); i++) {
+            if (trackCues.second[i] >= 0) {
+                file << trackCues.first << "\t" << i << "\t" << String(trackCues.second[i], 6) << std::endl;
+            }
+        }
+    }
+    file.close();
+}
@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    HotCueLibrary.h
+    Created: 19 Oct 2026 2:30:51pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include "HotCuePlayer.h"
+
+//==============================================================================
+/*
+    Keeps the hot cues of every track in the library and saves them to
+    HotCues.txt next to Playlist.txt, one "path, cue number, seconds" line per
+    cue.
+*/
+class HotCueLibrary
+{
+public:
+    HotCueLibrary();
+
+    // Function to get the cues of a track, unset cues are negative
+    Array<double> getCues(const File& track) const;
+
+    // Function to set or clear (with a negative position) one cue of a track and save the library
+    void setCue(const File& track, int index, double posInSecs);
+
+private:
+    // Function to update the txt file
+    void updateFile() const;
+
+    std::map<String, Array<double>> cues;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HotCueLibrary)
+};
@@ -0,0 +1,311 @@
+/*
+  ==============================================================================
+
+    HotCuePlayer.cpp
+    Created: 19 Oct 2026 1:46:27pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "HotCuePlayer.h"
+#include "RealtimeGuard.h"
+
+//==============================================================================
+HotCuePlayer::HotCuePlayer(AudioTransportSource& transportToUse, TimeSliceThread& threadToUse)
+                           : transport(transportToUse),
+                             thread(threadToUse)
+{
+    thread.addTimeSliceClient(this);
+}
+
+HotCuePlayer::~HotCuePlayer()
+{
+    thread.removeTimeSliceClient(this);
+}
+
+void HotCuePlayer::setReader(AudioFormatReader* newReader)
+{
+    const ScopedLock sl(readerLock);
+    reader.reset(newReader);
+
+    // The buffers belong to the old track, so they are all rendered again
+    for (auto& slot : slots) {
+        slot.renderedPosition = -1.0;
+        int expected = ready;
+        slot.state.compare_exchange_strong(expected, empty);
+    }
+    cancel();
+}
+
+void HotCuePlayer::setCue(int index, double posInSecs)
+{
+    if (index >= 0 && index < numHotCues) {
+        slots[index].position = posInSecs;
+        thread.moveToFrontOfQueue(this);
+    }
+}
+
+double HotCuePlayer::getCue(int index) const
+{
+    return (index >= 0 && index < numHotCues) ? slots[index].position.load() : -1.0;
+}
+
+void HotCuePlayer::trigger(int index, bool hold)
+{
+    if (index >= 0 && index < numHotCues && slots[index].position.load() >= 0) {
+        pendingHold = hold;
+        pendingTrigger = index;
+    }
+}
+
+void HotCuePlayer::release()
+{
+    pendingTrigger = -3;
+}
+
+bool HotCuePlayer::isHoldingTransport() const
+{
+    return holding;
+}
+
+bool HotCuePlayer::isHoldPending() const
+{
+    return pendingTrigger.load() >= 0 && pendingHold.load();
+}
+
+void HotCuePlayer::setReturnPosition(double posInSecs)
+{
+    returnPosition = posInSecs;
+}
+
+void HotCuePlayer::cancel()
+{
+    pendingTrigger = -2;
+}
+
+double HotCuePlayer::getCurrentPosition() const
+{
+    const double position = cuePosition.load();
+    return position >= 0 ? position : transport.getCurrentPosition();
+}
+
+void HotCuePlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    transport.prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    {
+        // The buffers are kept at the rate the transport plays at, so they are rendered again
+        const ScopedLock sl(readerLock);
+        outputSampleRate = sampleRate;
+        cueBufferSamples = roundToInt(cueBufferSeconds * sampleRate);
+        renderBuffer.setSize(2, cueBufferSamples);
+
+        for (auto& slot : slots) {
+            slot.buffer.setSize(2, cueBufferSamples);
+            slot.renderedPosition = -1.0;
+            slot.state = empty;
+        }
+    }
+
+    // Only the crossfade is kept of the old audio, so the buffer never has to grow with the block size
+    fadeBuffer.setSize(2, fadeSamples);
+    playingCue = -1;
+    holding = false;
+    cuePosition = -1.0;
+}
+
+void HotCuePlayer::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    auto& output = *bufferToFill.buffer;
+    const int start = bufferToFill.startSample;
+    const int numSamples = bufferToFill.numSamples;
+
+    const int cue = pendingTrigger.exchange(-1);
+
+    // The transport was moved or a new track was loaded, so the buffer that is playing is out of date
+    if (cue == -2 && playingCue >= 0) {
+        slots[playingCue].state = ready;
+        playingCue = -1;
+        holding = false;
+    }
+
+    // A held cue goes back to the transport when it is released, or at the start of the block it would run out in
+    if (holding && playingCue >= 0 && (cue == -3 || cueBufferSamples - cueReadPos < numSamples)) {
+        const int fade = jmin(fadeSamples, numSamples);
+        const int done = readFromCue(fadeBuffer, 0, fade);
+        fadeBuffer.clear(done, fade - done);
+        slots[playingCue].state = ready;
+        playingCue = -1;
+        holding = false;
+
+        // The transport was only parked near the return point while the cue was held, so it is moved there exactly
+        if (returnPosition >= 0) {
+            seekFromAudioThread(returnPosition);
+        }
+        transport.getNextAudioBlock(bufferToFill);
+        crossfadeFromFadeBuffer(output, start, numSamples);
+    }
+    // Triggers are quantised to the start of the block, with a short crossfade from the old audio
+    else if (cue >= 0) {
+        const int fade = jmin(fadeSamples, numSamples);
+        AudioSourceChannelInfo fadeInfo(&fadeBuffer, 0, fade);
+        if (playingCue >= 0) {
+            const int done = readFromCue(fadeBuffer, 0, fade);
+            fadeBuffer.clear(done, fade - done);
+            slots[playingCue].state = ready;
+            playingCue = -1;
+        }
+        else {
+            transport.getNextAudioBlock(fadeInfo);
+        }
+
+        auto& slot = slots[cue];
+        const double position = slot.position.load();
+        int expected = ready;
+
+        if (position >= 0 && slot.state.compare_exchange_strong(expected, playing)) {
+            playingCue = cue;
+            cueReadPos = 0;
+            holding = pendingHold.load();
+
+            // The transport moves to the end of the buffer so its read-ahead catches up while the buffer plays,
+            // unless the cue is held, when the transport is kept where playback goes back to
+            if (!holding) {
+                seekFromAudioThread(position + cueBufferSamples / outputSampleRate);
+            }
+            readFromCue(output, start, numSamples);
+        }
+        else {
+            // The buffer is not ready yet, so the cue falls back to a normal seek
+            holding = false;
+            seekFromAudioThread(jmax(0.0, position));
+            transport.getNextAudioBlock(bufferToFill);
+        }
+
+        crossfadeFromFadeBuffer(output, start, numSamples);
+    }
+    else if (playingCue >= 0) {
+        const int done = readFromCue(output, start, numSamples);
+
+        if (!transport.isPlaying()) {
+            // Paused while the cue was playing, so the buffer fades out and the transport waits where it stopped
+            output.applyGainRamp(start, done, 1.0f, 0.0f);
+            output.clear(start + done, numSamples - done);
+            slots[playingCue].state = ready;
+            playingCue = -1;
+            holding = false;
+            seekFromAudioThread(cuePosition.load() + done / outputSampleRate);
+        }
+        else if (done < numSamples) {
+            // The buffer has run out, so playback carries on from the transport
+            slots[playingCue].state = ready;
+            playingCue = -1;
+            AudioSourceChannelInfo rest(&output, start + done, numSamples - done);
+            transport.getNextAudioBlock(rest);
+        }
+    }
+    else {
+        transport.getNextAudioBlock(bufferToFill);
+    }
+
+    cuePosition = playingCue >= 0 ? slots[playingCue].position.load() + cueReadPos / outputSampleRate : -1.0;
+}
+
+void HotCuePlayer::releaseResources()
+{
+    transport.releaseResources();
+}
+
+void HotCuePlayer::seekFromAudioThread(double posInSecs)
+{
+    // Seeking sets the read-ahead's next position under its range lock, moves it to the front of its thread's
+    // queue and wakes it. None of it decodes or allocates, and the audio thread takes the same range lock to read
+    // every block, so it is let through the guard here, the one place the audio thread seeks from
+    RealtimeGuard::ScopedSuspend suspend;
+    transport.setPosition(posInSecs);
+}
+
+void HotCuePlayer::crossfadeFromFadeBuffer(AudioBuffer<float>& output, int startSample, int numSamples)
+{
+    const int fade = jmin(fadeSamples, numSamples);
+    for (int channel = 0; channel < output.getNumChannels(); ++channel) {
+        output.applyGainRamp(channel, startSample, fade, 0.0f, 1.0f);
+        output.addFromWithRamp(channel, startSample, fadeBuffer.getReadPointer(jmin(channel, fadeBuffer.getNumChannels() - 1)),
+                               fade, 1.0f, 0.0f);
+    }
+}
+
+int HotCuePlayer::readFromCue(AudioBuffer<float>& destination, int startSample, int numSamples)
+{
+    const auto& source = slots[playingCue].buffer;
+    const int numToCopy = jmin(numSamples, cueBufferSamples - cueReadPos);
+
+    for (int channel = 0; channel < destination.getNumChannels(); ++channel) {
+        destination.copyFrom(channel, startSample, source, jmin(channel, 1), cueReadPos, numToCopy);
+    }
+
+    cueReadPos += numToCopy;
+    return numToCopy;
+}
+
+int HotCuePlayer::useTimeSlice()
+{
+    const ScopedLock sl(readerLock);
+
+    if (reader == nullptr || outputSampleRate <= 0) {
+        return 500;
+    }
+
+    for (auto& slot : slots)
+    {
+        const double position = slot.position.load();
+
+        // Emptying the buffers of cues that have been cleared
+        if (position < 0) {
+            int expected = ready;
+            slot.state.compare_exchange_strong(expected, empty);
+            slot.renderedPosition = -1.0;
+            continue;
+        }
+
+        if (position == slot.renderedPosition) {
+            continue;
+        }
+
+        renderCue(position, renderBuffer);
+
+        // A buffer that is playing cannot be replaced, so it is tried again shortly
+        int expected = ready;
+        if (!slot.state.compare_exchange_strong(expected, rendering)) {
+            expected = empty;
+            if (!slot.state.compare_exchange_strong(expected, rendering)) {
+                return 20;
+            }
+        }
+
+        slot.buffer.makeCopyOf(renderBuffer, true);
+        slot.renderedPosition = position;
+        slot.state = ready;
+        return 0;
+    }
+
+    return 200;
+}
+
+void HotCuePlayer::renderCue(double posInSecs, AudioBuffer<float>& destination)
+{
+    // Reading a little more than a second at the file's rate and converting it to the output rate
+    const double ratio = reader->sampleRate / outputSampleRate;
+    const int numSourceSamples = (int) std::ceil(cueBufferSamples * ratio) + 8;
+
+    decodeBuffer.setSize(2, numSourceSamples, false, false, true);
+    decodeBuffer.clear();
+    reader->read(&decodeBuffer, 0, numSourceSamples, (int64) std::llround(posInSecs * reader->sampleRate), true, true);
+
+    for (int channel = 0; channel < 2; ++channel) {
+        LagrangeInterpolator interpolator;
+        interpolator.process(ratio, decodeBuffer.getReadPointer(channel), destination.getWritePointer(channel), cueBufferSamples);
+    }
+}
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    HotCuePlayer.h
+    Created: 19 Oct 2026 1:46:27pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Sits between a deck's transport and its speed resampler and plays hot cues.
+
+    A second of audio at each cue point is decoded ahead of time and kept in
+    RAM at the device sample rate. Triggering a cue switches the output to
+    that buffer at the start of the next audio block with a short crossfade,
+    and moves the transport to the end of the buffer so its read-ahead thread
+    can catch up while the buffer plays. When the buffer runs out, playback
+    carries on from the transport without a gap.
+
+    For slip mode a cue can be held instead: the transport is left where it
+    is, only the cue buffer is heard, and the cue goes back to the transport
+    with the same crossfade when it is released or its buffer runs out.
+
+    Every seek the audio thread makes goes through seekFromAudioThread: on a
+    cue trigger here, and when the deck slips or comes back from a slip.
+*/
+class HotCuePlayer  : public AudioSource,
+                      private TimeSliceClient
+{
+public:
+    static constexpr int numHotCues = 8;
+
+    HotCuePlayer(AudioTransportSource& transportToUse, TimeSliceThread& threadToUse);
+    ~HotCuePlayer() override;
+
+    /** give the player its own reader for decoding the cue buffers, the player takes ownership */
+    void setReader(AudioFormatReader* newReader);
+
+    /** set a cue point in seconds, or clear it with a negative position */
+    void setCue(int index, double posInSecs);
+
+    /** get a cue point in seconds, negative when it is not set */
+    double getCue(int index) const;
+
+    /** jump to a cue at the start of the next audio block, a held cue leaves the transport where it is */
+    void trigger(int index, bool hold = false);
+
+    /** go back to the transport from a held cue at the start of the next block, called on the audio thread */
+    void release();
+
+    /** true while a held cue is playing, called on the audio thread */
+    bool isHoldingTransport() const;
+
+    /** true when a held cue has been triggered and starts at the next block */
+    bool isHoldPending() const;
+
+    /** set where a held cue goes back to in seconds, called on the audio thread before each block. The transport
+        is moved there exactly when the cue is released or runs out, negative leaves it where it is */
+    void setReturnPosition(double posInSecs);
+
+    /** stop playing from a cue buffer, used when the transport is moved somewhere else */
+    void cancel();
+
+    /** get the position in seconds, which is inside the cue buffer while one is playing */
+    double getCurrentPosition() const;
+
+    /** move the transport, called on the audio thread. It never decodes, but takes the read-ahead's locks, so it
+        is only used once per cue, slip return or step of a slip, never every block */
+    void seekFromAudioThread(double posInSecs);
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+private:
+    int useTimeSlice() override;
+
+    // Function to decode the audio at a cue point into a buffer at the output sample rate
+    void renderCue(double posInSecs, AudioBuffer<float>& destination);
+
+    // Function to copy the next part of the playing cue buffer into the output
+    int readFromCue(AudioBuffer<float>& destination, int startSample, int numSamples);
+
+    // Function to fade the output in over the start of the block while the fade buffer fades out
+    void crossfadeFromFadeBuffer(AudioBuffer<float>& output, int startSample, int numSamples);
+
+    enum SlotState { empty, rendering, ready, playing };
+
+    // One cue point and its pre-decoded audio
+    struct Slot
+    {
+        std::atomic<double> position{ -1.0 };
+        double renderedPosition = -1.0;
+        std::atomic<int> state{ empty };
+        AudioBuffer<float> buffer;
+    };
+
+    // Seconds of audio kept in RAM for each cue
+    static constexpr double cueBufferSeconds = 1.0;
+
+    // Length of the crossfade when a cue is triggered, which is also the size of the fade buffer
+    static constexpr int fadeSamples = 128;
+
+    AudioTransportSource& transport;
+    TimeSliceThread& thread;
+
+    CriticalSection readerLock;
+    std::unique_ptr<AudioFormatReader> reader;
+    AudioBuffer<float> renderBuffer;
+    AudioBuffer<float> decodeBuffer;
+
+    Slot slots[numHotCues];
+    double outputSampleRate = 0;
+    int cueBufferSamples = 0;
+
+    // Written by the message thread, read by the audio thread
+    std::atomic<int> pendingTrigger{ -1 };
+    std::atomic<bool> pendingHold{ false };
+
+    // Only touched by the audio thread, apart from the published position
+    int playingCue = -1;
+    int cueReadPos = 0;
+    bool holding = false;
+    double returnPosition = -1.0;
+    AudioBuffer<float> fadeBuffer;
+    std::atomic<double> cuePosition{ -1.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HotCuePlayer)
+};
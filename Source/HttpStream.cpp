@@ -0,0 +1,402 @@
+/*
+  ==============================================================================
+
+    HttpStream.cpp
+    Created: 19 Oct 2026 11:04:31pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "HttpStream.h"
+
+//==============================================================================
+HttpStream::HttpStream(const URL& urlToStream, int64 maxCachedBytes)
+                       : Thread("HTTP stream"),
+                         url(urlToStream),
+                         maxChunks(jmax(4, (int) (maxCachedBytes / chunkSize)))
+{
+    startThread(Thread::Priority::normal);
+}
+
+HttpStream::~HttpStream()
+{
+    cancel();
+    stopThread(stopTimeoutMs);
+}
+
+bool HttpStream::waitForPreBuffer(int64 numBytes)
+{
+    while (!*cancelled && !failed)
+    {
+        {
+            // Counting how much of the start of the file is in the cache
+            const ScopedLock sl(lock);
+            int64 contiguous = 0;
+            for (auto it = chunks.find(0); it != chunks.end() && it->first == contiguous / chunkSize; ++it) {
+                contiguous += (int64) it->second.getSize();
+            }
+
+            const bool complete = totalLength >= 0 && contiguous >= totalLength;
+            if (contiguous >= numBytes || complete) {
+                return true;
+            }
+        }
+        dataArrived.wait(50);
+    }
+    return false;
+}
+
+void HttpStream::cancel()
+{
+    *cancelled = true;
+    dataArrived.signal();
+
+    // A connect or a read blocked on the server gives up straight away
+    {
+        const ScopedLock sl(connectionLock);
+        if (connection != nullptr) {
+            connection->cancel();
+        }
+    }
+    notify();
+}
+
+std::shared_ptr<std::atomic<bool>> HttpStream::getCancelFlag() const
+{
+    return cancelled;
+}
+
+int64 HttpStream::getTotalLength()
+{
+    const ScopedLock sl(lock);
+    return totalLength;
+}
+
+bool HttpStream::isExhausted()
+{
+    const ScopedLock sl(lock);
+    return totalLength >= 0 && position >= totalLength;
+}
+
+int HttpStream::read(void* destBuffer, int maxBytesToRead)
+{
+    auto* dest = static_cast<char*>(destBuffer);
+    int done = 0;
+
+    while (done < maxBytesToRead && !*cancelled)
+    {
+        {
+            const ScopedLock sl(lock);
+            readPosition = position;
+
+            if (totalLength >= 0 && position >= totalLength) {
+                break;
+            }
+
+            auto it = chunks.find(position / chunkSize);
+            if (it != chunks.end()) {
+                const int offset = (int) (position % chunkSize);
+                const int available = (int) it->second.getSize() - offset;
+                if (available <= 0) {
+                    break;
+                }
+
+                const int numToCopy = jmin(available, maxBytesToRead - done);
+                memcpy(dest + done, static_cast<const char*>(it->second.getData()) + offset, (size_t) numToCopy);
+                done += numToCopy;
+                position += numToCopy;
+                continue;
+            }
+
+            if (failed) {
+                break;
+            }
+        }
+
+        // The data is not here yet, so the download thread is woken and the read waits for it
+        notify();
+        dataArrived.wait(100);
+    }
+
+    return done;
+}
+
+int64 HttpStream::getPosition()
+{
+    return position;
+}
+
+bool HttpStream::setPosition(int64 newPosition)
+{
+    position = jmax((int64) 0, newPosition);
+    readPosition = position;
+    notify();
+    return true;
+}
+
+bool HttpStream::openAt(int64 start, int64& streamPosition)
+{
+    closeConnection();
+
+    auto stream = std::make_unique<WebInputStream>(url, false);
+    stream->withExtraHeaders("Range: bytes=" + String(start) + "-")
+           .withConnectionTimeout(connectTimeoutMs);
+
+    // The request is made where cancel can reach it, so deleting the stream never waits out the timeout
+    {
+        const ScopedLock sl(connectionLock);
+        if (*cancelled) {
+            return false;
+        }
+        connection = std::move(stream);
+    }
+
+    if (!connection->connect(nullptr)) {
+        closeConnection();
+        return false;
+    }
+
+    const int statusCode = connection->getStatusCode();
+    const StringPairArray headers = connection->getResponseHeaders();
+
+    const ScopedLock sl(lock);
+
+    if (statusCode == 206) {
+        // Content-Range looks like "bytes 1000-1999/5000"
+        rangesSupported = true;
+        const String total = headers["Content-Range"].fromLastOccurrenceOf("/", false, false).trim();
+        if (total.containsOnly("0123456789") && total.isNotEmpty()) {
+            totalLength = total.getLargeIntValue();
+        }
+        streamPosition = start;
+        return true;
+    }
+
+    if (statusCode == 200) {
+        // The server ignored the range, so the response is the whole file from the start
+        rangesSupported = false;
+        if (connection->getTotalLength() >= 0) {
+            totalLength = connection->getTotalLength();
+        }
+        streamPosition = 0;
+        return true;
+    }
+
+    closeConnection();
+    return false;
+}
+
+void HttpStream::closeConnection()
+{
+    const ScopedLock sl(connectionLock);
+    connection.reset();
+}
+
+int64 HttpStream::findChunkToFetch() const
+{
+    const ScopedLock sl(lock);
+
+    // Staying three quarters of the cache ahead of the reader, so what it is about to read is never evicted
+    const int64 readChunk = readPosition.load() / chunkSize;
+    int64 lastChunk = readChunk + maxChunks * 3 / 4;
+    if (totalLength >= 0) {
+        lastChunk = jmin(lastChunk, (totalLength + chunkSize - 1) / chunkSize);
+    }
+
+    for (int64 chunk = readChunk; chunk < lastChunk; ++chunk) {
+        if (chunks.find(chunk) == chunks.end()) {
+            return chunk;
+        }
+    }
+    return -1;
+}
+
+void HttpStream::evictChunks()
+{
+    const int64 readChunk = readPosition.load() / chunkSize;
+
+    while ((int) chunks.size() > maxChunks) {
+        // Dropping whichever end of the cache is further from the reader
+        const int64 first = chunks.begin()->first;
+        const int64 last = chunks.rbegin()->first;
+        chunks.erase(readChunk - first > last - readChunk ? first : last);
+    }
+}
+
+void HttpStream::run()
+{
+    int64 streamPosition = 0;
+    int failures = 0;
+    HeapBlock<char> chunkData(chunkSize);
+
+    while (!threadShouldExit() && !*cancelled)
+    {
+        const int64 wanted = findChunkToFetch();
+        if (wanted < 0) {
+            // The reader is far enough behind, so the connection is closed until it catches up
+            closeConnection();
+            wait(100);
+            continue;
+        }
+
+        const int64 wantedPosition = wanted * chunkSize;
+
+        // A seek away from the open connection makes a new request, or starts again when ranges are not supported
+        const bool canReadOn = connection != nullptr
+                               && (streamPosition == wantedPosition || (!rangesSupported && streamPosition < wantedPosition));
+        if (!canReadOn) {
+            if (!openAt(wantedPosition, streamPosition)) {
+                if (*cancelled) {
+                    break;
+                }
+                if (++failures >= maxFailures) {
+                    failed = true;
+                    dataArrived.signal();
+                    return;
+                }
+                wait(500 * failures);
+                continue;
+            }
+            failures = 0;
+        }
+
+        int numRead = 0;
+        while (numRead < chunkSize && !threadShouldExit() && !*cancelled) {
+            const int n = connection->read(chunkData + numRead, chunkSize - numRead);
+            if (n <= 0) {
+                break;
+            }
+            numRead += n;
+        }
+
+        {
+            const ScopedLock sl(lock);
+
+            const bool endOfFile = numRead < chunkSize
+                                   && (totalLength < 0 || streamPosition + numRead >= totalLength);
+
+            // A connection that dropped part way through a chunk is made again, rather than caching a short chunk
+            if (numRead == chunkSize || endOfFile) {
+                if (numRead > 0) {
+                    chunks[streamPosition / chunkSize] = MemoryBlock(chunkData, (size_t) numRead);
+                    evictChunks();
+                }
+                if (endOfFile) {
+                    totalLength = streamPosition + numRead;
+                }
+            }
+        }
+
+        if (numRead < chunkSize) {
+            closeConnection();
+        }
+
+        if (numRead == chunkSize) {
+            streamPosition += numRead;
+        }
+        dataArrived.signal();
+    }
+}
+
+//==============================================================================
+HttpStreamLoader::HttpStreamLoader(AudioFormatManager& formatManagerToUse)
+                                   : Thread("HTTP stream loader"),
+                                     formatManager(formatManagerToUse)
+{
+}
+
+HttpStreamLoader::~HttpStreamLoader()
+{
+    cancel();
+    stopThread(5000);
+}
+
+void HttpStreamLoader::load(const URL& url, int64 preBufferBytes, Callback onLoaded)
+{
+    {
+        const ScopedLock sl(lock);
+        pendingURL = url;
+        pendingPreBuffer = preBufferBytes;
+        pendingCallback = std::move(onLoaded);
+        hasRequest = true;
+        loading = true;
+
+        // The stream being opened is no longer wanted
+        if (currentCancel != nullptr) {
+            *currentCancel = true;
+        }
+    }
+
+    if (!isThreadRunning()) {
+        startThread(Thread::Priority::normal);
+    }
+    notify();
+}
+
+void HttpStreamLoader::cancel()
+{
+    const ScopedLock sl(lock);
+    hasRequest = false;
+    loading = false;
+    if (currentCancel != nullptr) {
+        *currentCancel = true;
+    }
+}
+
+bool HttpStreamLoader::isLoading() const
+{
+    return loading;
+}
+
+void HttpStreamLoader::run()
+{
+    while (!threadShouldExit())
+    {
+        URL url;
+        int64 preBuffer = 0;
+        Callback callback;
+        std::unique_ptr<HttpStream> stream;
+
+        {
+            const ScopedLock sl(lock);
+            if (hasRequest) {
+                url = pendingURL;
+                preBuffer = pendingPreBuffer;
+                callback = pendingCallback;
+                hasRequest = false;
+                stream = std::make_unique<HttpStream>(url);
+
+                // Only the flag is kept, as the format manager deletes the stream when no format can read it
+                currentCancel = stream->getCancelFlag();
+            }
+        }
+
+        if (stream == nullptr) {
+            wait(-1);
+            continue;
+        }
+
+        // Reading the format only once the pre-buffer is in, so the reader starts with enough to play
+        std::unique_ptr<AudioFormatReader> reader;
+        if (stream->waitForPreBuffer(preBuffer)) {
+            reader.reset(formatManager.createReaderFor(std::unique_ptr<InputStream>(stream.release())));
+        }
+
+        {
+            const ScopedLock sl(lock);
+            currentCancel = nullptr;
+
+            // A newer request came in while this one was opening
+            if (hasRequest) {
+                continue;
+            }
+            loading = false;
+        }
+
+        // The callback decides on the message thread whether the reader is still wanted, otherwise it is deleted here
+        auto holder = std::make_shared<std::unique_ptr<AudioFormatReader>>(std::move(reader));
+        MessageManager::callAsync([callback, holder] { callback(*holder); });
+    }
+}
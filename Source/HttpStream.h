@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    HttpStream.h
+    Created: 19 Oct 2026 11:04:31pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <map>
+
+//==============================================================================
+/*
+    An input stream over an HTTP URL that downloads in the background.
+
+    The file is fetched in 64KB chunks into a sparse cache, starting from
+    wherever the stream is being read and staying a bounded distance ahead of
+    it. When the reader seeks somewhere that has not been downloaded, the
+    connection is dropped and a range request is made from the new position.
+    Servers that do not support ranges are read from the start instead. The
+    cache never holds more than its limit, dropping the chunks furthest from
+    the read position first.
+
+    Reads wait for their data to arrive, so the stream should only be read on
+    a background thread. Cancelling or deleting the stream aborts the request
+    in flight, so a slow server never holds up the thread deleting it.
+*/
+class HttpStream  : public InputStream,
+                    private Thread
+{
+public:
+    HttpStream(const URL& urlToStream, int64 maxCachedBytes = 64 * 1024 * 1024);
+    ~HttpStream() override;
+
+    /** wait until the start of the file has been downloaded, returns false if it failed or was cancelled */
+    bool waitForPreBuffer(int64 numBytes);
+
+    /** make any read that is waiting for data give up, used when the stream is no longer wanted */
+    void cancel();
+
+    /** get the flag cancel sets, which can be kept and set after the stream has been handed on or deleted */
+    std::shared_ptr<std::atomic<bool>> getCancelFlag() const;
+
+    int64 getTotalLength() override;
+    bool isExhausted() override;
+    int read(void* destBuffer, int maxBytesToRead) override;
+    int64 getPosition() override;
+    bool setPosition(int64 newPosition) override;
+
+private:
+    void run() override;
+
+    // Function to make a request from a position, giving back where the response actually starts
+    bool openAt(int64 position, int64& streamPosition);
+
+    // Function to close the request in flight, called on the download thread
+    void closeConnection();
+
+    // Function to find the next chunk the reader will need that has not been downloaded
+    int64 findChunkToFetch() const;
+
+    // Function to keep the cache under its limit, called with the lock held
+    void evictChunks();
+
+    static constexpr int chunkSize = 65536;
+    static constexpr int maxFailures = 5;
+
+    // A request that cannot connect gives up well before the thread is waited for when the stream is deleted
+    static constexpr int connectTimeoutMs = 3000;
+    static constexpr int stopTimeoutMs = 5000;
+
+    const URL url;
+    const int maxChunks;
+
+    CriticalSection lock;
+    std::map<int64, MemoryBlock> chunks;
+    int64 totalLength = -1;
+    bool rangesSupported = true;
+
+    WaitableEvent dataArrived;
+    std::atomic<int64> readPosition{ 0 };
+    std::atomic<bool> failed{ false };
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    // Only used by the thread reading the stream
+    int64 position = 0;
+
+    // The request in flight, only replaced by the download thread, and cancelled under the lock from any thread
+    CriticalSection connectionLock;
+    std::unique_ptr<WebInputStream> connection;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HttpStream)
+};
+
+//==============================================================================
+/*
+    Opens HTTP streams on a background thread, so a slow server never holds
+    up the message thread. Once the pre-buffer has been downloaded and the
+    format has been read, the reader is handed to the callback on the message
+    thread.
+*/
+class HttpStreamLoader  : private Thread
+{
+public:
+    using Callback = std::function<void(std::unique_ptr<AudioFormatReader>&)>;
+
+    HttpStreamLoader(AudioFormatManager& formatManagerToUse);
+    ~HttpStreamLoader() override;
+
+    /** start opening a stream, dropping any stream that is still being opened */
+    void load(const URL& url, int64 preBufferBytes, Callback onLoaded);
+
+    /** stop opening the current stream */
+    void cancel();
+
+    bool isLoading() const;
+
+private:
+    void run() override;
+
+    AudioFormatManager& formatManager;
+
+    CriticalSection lock;
+    URL pendingURL;
+    int64 pendingPreBuffer = 0;
+    Callback pendingCallback;
+    bool hasRequest = false;
+
+    // The cancel flag of the stream being opened, which stays valid once the stream belongs to a reader
+    std::shared_ptr<std::atomic<bool>> currentCancel;
+    std::atomic<bool> loading{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HttpStreamLoader)
+};
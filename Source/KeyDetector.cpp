@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    KeyDetector.cpp
+    Created: 21 Oct 2026 4:36:02pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "KeyDetector.h"
+
+#include <cmath>
+
+//==============================================================================
+namespace
+{
+    // Krumhansl-Kessler key profiles, from the tonic upwards
+    const float majorProfile[12] = { 6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f };
+    const float minorProfile[12] = { 6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f };
+
+    const char* const pitchNames[12] = { "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+
+    // Function to get the correlation of the chroma, rotated to start at the tonic, with a profile
+    float correlate(const float* chroma, int tonic, const float* profile)
+    {
+        float chromaMean = 0.0f, profileMean = 0.0f;
+        for (int i = 0; i < 12; ++i) {
+            chromaMean += chroma[i];
+            profileMean += profile[i];
+        }
+        chromaMean /= 12.0f;
+        profileMean /= 12.0f;
+
+        float product = 0.0f, chromaSquares = 0.0f, profileSquares = 0.0f;
+        for (int i = 0; i < 12; ++i) {
+            const float c = chroma[(i + tonic) % 12] - chromaMean;
+            const float p = profile[i] - profileMean;
+            product += c * p;
+            chromaSquares += c * c;
+            profileSquares += p * p;
+        }
+        return chromaSquares > 0.0f ? product / std::sqrt(chromaSquares * profileSquares) : 0.0f;
+    }
+}
+
+//==============================================================================
+KeyDetector::KeyDetector()
+    : fftData(fftSize * 2, true),
+      spectrumSum(numBins, true)
+{
+}
+
+KeyDetector::~KeyDetector()
+{
+}
+
+int KeyDetector::detect(AudioFormatReader& reader, const std::function<bool()>& shouldStop)
+{
+    if (reader.lengthInSamples <= 0 || reader.sampleRate <= 0.0 || reader.numChannels == 0) {
+        return -1;
+    }
+
+    // Averaging each group of samples down to around 11kHz, which keeps the FFT small and still covers C7
+    const int decimation = jmax(1, (int) (reader.sampleRate / targetRate));
+    prepare(reader.sampleRate / decimation);
+
+    // Analysing the middle of the track, where the intro and outro do not pull it towards another key
+    const int64 analysed = jmin(reader.lengthInSamples, (int64) (maxSecondsAnalysed * reader.sampleRate));
+    const int64 start = (reader.lengthInSamples - analysed) / 2;
+    const int frameSamples = fftSize * decimation;
+    const int numChannels = jmin(2, (int) reader.numChannels);
+    readBuffer.setSize(numChannels, frameSamples, false, false, true);
+    FloatVectorOperations::clear(spectrumSum.get(), numBins);
+
+    int numFrames = 0;
+    for (int64 position = start; position + frameSamples <= start + analysed; position += frameSamples) {
+        if (shouldStop != nullptr && shouldStop()) {
+            return -1;
+        }
+        if (!reader.read(&readBuffer, 0, frameSamples, position, true, numChannels > 1)) {
+            return -1;
+        }
+
+        float* mono = readBuffer.getWritePointer(0);
+        if (numChannels > 1) {
+            FloatVectorOperations::add(mono, readBuffer.getReadPointer(1), frameSamples);
+        }
+        for (int i = 0; i < fftSize; ++i) {
+            float sum = 0.0f;
+            for (int j = 0; j < decimation; ++j) {
+                sum += mono[i * decimation + j];
+            }
+            fftData[i] = sum;
+        }
+        FloatVectorOperations::clear(fftData + fftSize, fftSize);
+
+        window.multiplyWithWindowingTable(fftData.get(), (size_t) fftSize);
+        fft.performFrequencyOnlyForwardTransform(fftData.get());
+
+        // Silent frames are left out rather than scaled up
+        const float peak = FloatVectorOperations::findMaximum(fftData.get(), numBins);
+        if (peak > 1.0e-4f) {
+            FloatVectorOperations::addWithMultiply(spectrumSum.get(), fftData.get(), 1.0f / peak, numBins);
+            ++numFrames;
+        }
+    }
+
+    if (numFrames == 0) {
+        return -1;
+    }
+
+    // Folding the spectrum into the twelve pitch classes
+    float chroma[12] = {};
+    for (int bin = 0; bin < numBins; ++bin) {
+        if (binPitchClass[(size_t) bin] >= 0) {
+            chroma[binPitchClass[(size_t) bin]] += spectrumSum[bin];
+        }
+    }
+    return matchProfiles(chroma);
+}
+
+String KeyDetector::getCamelotName(int key)
+{
+    if (key < 0 || key >= numKeys) {
+        return {};
+    }
+    return String(getCamelotNumber(key)) + (key < 12 ? "B" : "A");
+}
+
+String KeyDetector::getKeyName(int key)
+{
+    if (key < 0 || key >= numKeys) {
+        return {};
+    }
+    return String(pitchNames[key % 12]) + (key < 12 ? "" : "m");
+}
+
+bool KeyDetector::areCompatible(int key, int otherKey)
+{
+    if (key < 0 || key >= numKeys || otherKey < 0 || otherKey >= numKeys) {
+        return false;
+    }
+
+    const int number = getCamelotNumber(key);
+    const int otherNumber = getCamelotNumber(otherKey);
+
+    // The relative major or minor sits at the same number on the other ring
+    if ((key < 12) != (otherKey < 12)) {
+        return number == otherNumber;
+    }
+
+    const int steps = (otherNumber - number + 12) % 12;
+    return steps == 0 || steps == 1 || steps == 11;
+}
+
+void KeyDetector::prepare(double analysisRate)
+{
+    if (analysisRate == preparedRate) {
+        return;
+    }
+    preparedRate = analysisRate;
+
+    binPitchClass.assign((size_t) numBins, -1);
+    for (int bin = 1; bin < numBins; ++bin) {
+        const double hz = bin * analysisRate / fftSize;
+        if (hz < lowestHz || hz > highestHz) {
+            continue;
+        }
+        const int note = roundToInt(69.0 + 12.0 * std::log2(hz / 440.0));
+        binPitchClass[(size_t) bin] = note % 12;
+    }
+}
+
+int KeyDetector::matchProfiles(const float* chroma)
+{
+    int bestKey = -1;
+    float bestCorrelation = -2.0f;
+    for (int tonic = 0; tonic < 12; ++tonic) {
+        const float major = correlate(chroma, tonic, majorProfile);
+        if (major > bestCorrelation) {
+            bestCorrelation = major;
+            bestKey = tonic;
+        }
+        const float minor = correlate(chroma, tonic, minorProfile);
+        if (minor > bestCorrelation) {
+            bestCorrelation = minor;
+            bestKey = tonic + 12;
+        }
+    }
+    return bestKey;
+}
+
+int KeyDetector::getCamelotNumber(int key)
+{
+    // Going up a fifth is one step round the wheel, with C major at 8B and A minor at 8A
+    const int tonic = key % 12;
+    return key < 12 ? (7 * tonic + 7) % 12 + 1 : (7 * tonic + 4) % 12 + 1;
+}
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    KeyDetector.h
+    Created: 21 Oct 2026 4:36:02pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/*
+    Finds the musical key of a track from its chroma.
+
+    Up to two minutes from the middle of the track are mixed to mono and
+    brought down to around 11kHz, then cut into frames that go through the
+    FFT. Each frame's magnitudes are scaled to its peak and added into one
+    running spectrum with vector operations, so every frame counts the same
+    however loud it is. As folding is linear, the running spectrum is only
+    folded into the twelve pitch classes once at the end, through a table of
+    the pitch class of each bin. The chroma is then matched against the
+    Krumhansl-Kessler profiles of the 24 major and minor keys.
+
+    Keys are numbered 0 to 11 for C major to B major, and 12 to 23 for C
+    minor to B minor. A detector is not thread safe, each worker uses its own.
+*/
+class KeyDetector
+{
+public:
+    KeyDetector();
+    ~KeyDetector();
+
+    /** find the key of a track, or -1 if it cannot be read or is silent. shouldStop is asked between frames */
+    int detect(AudioFormatReader& reader, const std::function<bool()>& shouldStop = nullptr);
+
+    /** get the position of a key on the Camelot wheel, such as "8A" for A minor, or an empty string for -1 */
+    static String getCamelotName(int key);
+
+    /** get the short musical name of a key, such as "Am" or "F#" */
+    static String getKeyName(int key);
+
+    /** true if two keys mix well: the same key, a step either way round the wheel, or the relative major or minor */
+    static bool areCompatible(int key, int otherKey);
+
+    static constexpr int numKeys = 24;
+
+private:
+    // Function to build the table of the pitch class of each bin for the rate the frames are analysed at
+    void prepare(double analysisRate);
+
+    // Function to find the key whose profile matches the chroma best
+    static int matchProfiles(const float* chroma);
+
+    // Function to get the number of a key on the Camelot wheel, from 1 to 12
+    static int getCamelotNumber(int key);
+
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2 + 1;
+    static constexpr double targetRate = 11025.0;
+    static constexpr double maxSecondsAnalysed = 120.0;
+
+    // Pitches outside C2 to C7 are left out of the chroma, the bass is too coarse and the top is mostly overtones
+    static constexpr double lowestHz = 65.0;
+    static constexpr double highestHz = 2100.0;
+
+    dsp::FFT fft{ fftOrder };
+    dsp::WindowingFunction<float> window{ (size_t) fftSize, dsp::WindowingFunction<float>::hann, false };
+
+    AudioBuffer<float> readBuffer;
+    HeapBlock<float> fftData;
+    HeapBlock<float> spectrumSum;
+
+    // The pitch class of each bin, -1 for the bins outside the range
+    std::vector<int> binPitchClass;
+    double preparedRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KeyDetector)
+};
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    KeyLibrary.cpp
+    Created: 21 Oct 2026 5:12:44pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <fstream>
+#include "KeyLibrary.h"
+#include "KeyDetector.h"
+#include "Tracer.h"
+
+//==============================================================================
+KeyLibrary::KeyLibrary(std::function<void(const Array<Result>&)> onKeysFound)
+    : onKeys(std::move(onKeysFound))
+{
+}
+
+KeyLibrary::~KeyLibrary()
+{
+    // The jobs check the flag between frames, so the running ones finish quickly
+    stopping = true;
+    pool.removeAllJobs(true, 10000);
+    cancelPendingUpdate();
+
+    if (isTimerRunning()) {
+        saveCache();
+    }
+}
+
+int KeyLibrary::getKey(const File& track) const
+{
+    const int index = cachedPaths.indexOf(track.getFullPathName());
+    return index >= 0 ? cachedKeys[(size_t) index] : -1;
+}
+
+void KeyLibrary::analyse(const Array<File>& tracks)
+{
+    Array<File> batch;
+    for (auto& track : tracks) {
+        const String trackPath = track.getFullPathName();
+        if (cachedPaths.contains(trackPath) || queuedPaths.contains(trackPath)) {
+            continue;
+        }
+
+        queuedPaths.add(trackPath);
+        batch.add(track);
+        if (batch.size() >= batchSize) {
+            queueBatch(batch);
+            batch.clearQuick();
+        }
+    }
+    queueBatch(batch);
+}
+
+void KeyLibrary::queueBatch(const Array<File>& tracks)
+{
+    if (tracks.isEmpty()) {
+        return;
+    }
+
+    pool.addJob([this, tracks] {
+        TraceSpan span("KeyLibrary batch");
+
+        KeyDetector detector;
+        for (auto& track : tracks) {
+            if (stopping) {
+                return;
+            }
+
+            // A plain reader is enough, the track is read straight through once
+            std::unique_ptr<AudioFormatReader> reader(decoders->createReaderFor(track, false));
+            const int key = reader != nullptr ? detector.detect(*reader, [this] { return stopping.load(); }) : -1;
+            if (stopping) {
+                return;
+            }
+
+            const ScopedLock sl(pendingLock);
+            pending.add({ track, key });
+            triggerAsyncUpdate();
+        }
+    });
+}
+
+void KeyLibrary::handleAsyncUpdate()
+{
+    Array<Result> found;
+    {
+        const ScopedLock sl(pendingLock);
+        found.swapWith(pending);
+    }
+
+    for (auto& result : found) {
+        const String trackPath = result.file.getFullPathName();
+        const int index = cachedPaths.indexOf(trackPath);
+        if (index >= 0) {
+            cachedKeys[(size_t) index] = (int8) result.key;
+        }
+        else {
+            cachedPaths.add(trackPath);
+            cachedKeys.push_back((int8) result.key);
+        }
+    }
+
+    // Once the pool is idle every queued track is in the cache, so the queue can give back its space
+    if (pool.getNumJobs() == 0) {
+        queuedPaths.clear();
+    }
+
+    startTimer(saveDelayMs);
+    onKeys(found);
+}
+
+void KeyLibrary::timerCallback()
+{
+    stopTimer();
+    saveCache();
+}
+
+void KeyLibrary::loadCache()
+{
+    TraceSpan span("KeyLibrary::loadCache");
+
+    std::ifstream file("Keys.txt");
+    std::string string;
+    while (std::getline(file, string)) {
+        const String line(CharPointer_UTF8(string.c_str()));
+        const String trackPath = line.fromFirstOccurrenceOf("\t", false, false);
+        const int key = line.upToFirstOccurrenceOf("\t", false, false).getIntValue();
+        if (trackPath.isEmpty() || key < -1 || key >= KeyDetector::numKeys || cachedPaths.contains(trackPath)) {
+            continue;
+        }
+
+        cachedPaths.add(trackPath);
+        cachedKeys.push_back((int8) key);
+    }
+}
+
+void KeyLibrary::saveCache() const
+{
+    // Writing to Keys.txt
+    std::ofstream file("Keys.txt");
+    for (int i = 0; i < cachedPaths.size(); i++) {
+        file << (int) cachedKeys[(size_t) i] << "\t" << cachedPaths.getPath(i).toStdString() << "\n";
+    }
+}
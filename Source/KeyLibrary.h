@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    KeyLibrary.h
+    Created: 21 Oct 2026 5:12:44pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "DecoderService.h"
+#include "TrackStore.h"
+
+//==============================================================================
+/*
+    The keys of the tracks in the library, found in the background and
+    saved to Keys.txt next to Playlist.txt, one "key <tab> path" line per
+    track.
+
+    Tracks that have not been analysed are queued in small batches on a pool
+    with one thread less than there are cores, so the message thread and the
+    audio keep a core to themselves. Each result is handed to the callback on
+    the message thread as it comes in. Tracks that could not be read are
+    saved with a key of -1 so they are not tried again every run.
+
+    Keys.txt is only read when loadCache is called, which the library does
+    once the window is showing, so a big cache does not hold up startup.
+*/
+class KeyLibrary  : private AsyncUpdater,
+                    private Timer
+{
+public:
+    struct Result
+    {
+        File file;
+        int key = -1;
+    };
+
+    KeyLibrary(std::function<void(const Array<Result>&)> onKeysFound);
+    ~KeyLibrary() override;
+
+    /** get the key of a track that has been analysed, or -1 */
+    int getKey(const File& track) const;
+
+    /** queue the tracks that have not been analysed and are not already queued */
+    void analyse(const Array<File>& tracks);
+
+    /** read the keys saved in Keys.txt, keeping any found since the library was created */
+    void loadCache();
+
+private:
+    void handleAsyncUpdate() override;
+
+    // Function to save the keys once no new ones have come in for a while
+    void timerCallback() override;
+
+    // Function to queue a batch of tracks on the pool
+    void queueBatch(const Array<File>& tracks);
+
+    // Function to write Keys.txt
+    void saveCache() const;
+
+    static constexpr int batchSize = 16;
+    static constexpr int saveDelayMs = 2000;
+
+    SharedResourcePointer<DecoderService> decoders;
+    std::function<void(const Array<Result>&)> onKeys;
+
+    // Only touched on the message thread, the keys are in the same order as the paths
+    TrackStore cachedPaths;
+    std::vector<int8> cachedKeys;
+    TrackStore queuedPaths;
+
+    CriticalSection pendingLock;
+    Array<Result> pending;
+
+    std::atomic<bool> stopping{ false };
+    ThreadPool pool{ jmax(1, SystemStats::getNumCpus() - 1) };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KeyLibrary)
+};
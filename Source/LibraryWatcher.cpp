@@ -0,0 +1,633 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.cpp
+    Created: 20 Oct 2026 11:42:15am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "LibraryWatcher.h"
+#include "Tracer.h"
+
+#include <fstream>
+
+#if JUCE_LINUX
+ #include <sys/inotify.h>
+ #include <poll.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+LibraryWatcher::LibraryWatcher(std::function<void(const Changes&)> onLibraryChanged)
+                               : Thread("Library watcher"),
+                                 onChange(std::move(onLibraryChanged))
+{
+    loadFolders();
+    startThread(Thread::Priority::low);
+}
+
+LibraryWatcher::~LibraryWatcher()
+{
+    cancelPendingUpdate();
+    stopThread(10000);
+}
+
+void LibraryWatcher::addFolder(const File& folder)
+{
+    {
+        const ScopedLock sl(folderLock);
+        if (!folder.isDirectory() || folders.contains(folder)) {
+            return;
+        }
+        folders.add(folder);
+    }
+    saveFolders();
+
+    // Scanning again lists the new folder, while every other folder comes out of the cache
+    rescanRequested = true;
+    notify();
+}
+
+void LibraryWatcher::removeFolder(const File& folder)
+{
+    {
+        const ScopedLock sl(folderLock);
+        if (!folders.contains(folder)) {
+            return;
+        }
+        folders.removeAllInstancesOf(folder);
+    }
+    saveFolders();
+
+    rescanRequested = true;
+    notify();
+}
+
+Array<File> LibraryWatcher::getFolders() const
+{
+    const ScopedLock sl(folderLock);
+    return folders;
+}
+
+bool LibraryWatcher::isInWatchedFolder(const File& file) const
+{
+    const ScopedLock sl(folderLock);
+    for (auto& folder : folders) {
+        if (file.isAChildOf(folder)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LibraryWatcher::run()
+{
+   #if JUCE_LINUX
+    // Watches are added while scanning, so nothing that changes during the scan is missed
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+   #endif
+
+    // Adding or removing a folder wakes the thread to scan again, from the cache the last scan left
+    while (!threadShouldExit())
+    {
+        rescanRequested = false;
+        loadCache();
+        scanAll();
+
+        // A scan cut short by the thread stopping has not found everything, so the cache is left as it was
+        if (threadShouldExit()) {
+            break;
+        }
+        saveCache();
+
+       #if JUCE_LINUX
+        if (inotifyFd >= 0) {
+            pruneWatches();
+            watchForChanges();
+            saveCache();
+            continue;
+        }
+       #endif
+
+        while (!threadShouldExit() && !rescanRequested) {
+            wait(250);
+        }
+    }
+
+   #if JUCE_LINUX
+    if (inotifyFd >= 0) {
+        {
+            const ScopedLock sl(watchLock);
+            watches.clear();
+        }
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+   #endif
+}
+
+void LibraryWatcher::handleAsyncUpdate()
+{
+    Array<Changes> batches;
+    {
+        const ScopedLock sl(pendingLock);
+        batches.swapWith(pending);
+    }
+
+    for (auto& changes : batches) {
+        onChange(changes);
+    }
+}
+
+void LibraryWatcher::scanAll()
+{
+    TraceSpan span("LibraryWatcher scan");
+
+    CriticalSection resultLock;
+    std::unordered_map<String, double> tracksFound;
+    std::unordered_map<String, int64> directoriesFound;
+
+    {
+        // Every directory is its own job, so deep and wide folders are both spread over the pool
+        ThreadPool pool(jmax(1, SystemStats::getNumCpus()));
+        std::function<void(const File&)> queueDirectory;
+        queueDirectory = [&](const File& directory) {
+            pool.addJob([&, directory] {
+                if (!threadShouldExit()) {
+                    scanDirectory(directory, queueDirectory, resultLock, tracksFound, directoriesFound);
+                }
+            });
+        };
+
+        for (auto& folder : getFolders()) {
+            queueDirectory(folder);
+        }
+
+        while (pool.getNumJobs() > 0) {
+            if (threadShouldExit()) {
+                pool.removeAllJobs(true, 10000);
+                return;
+            }
+            Thread::sleep(5);
+        }
+    }
+
+    // Telling the library only about what is different from what it already has
+    Changes changes;
+    for (auto& track : tracksFound) {
+        if (known.find(track.first) == known.end()) {
+            changes.added.add({ File(track.first), track.second });
+        }
+    }
+    for (auto& track : known) {
+        if (tracksFound.find(track.first) == tracksFound.end()) {
+            changes.removed.add(File(track.first));
+        }
+    }
+
+    known = std::move(tracksFound);
+    directoryTimes = std::move(directoriesFound);
+    post(std::move(changes));
+}
+
+void LibraryWatcher::scanDirectory(const File& directory, std::function<void(const File&)> onSubdirectory,
+                                   CriticalSection& resultLock, std::unordered_map<String, double>& tracksFound,
+                                   std::unordered_map<String, int64>& directoriesFound)
+{
+   #if JUCE_LINUX
+    addWatch(directory);
+   #endif
+
+    const String path = directory.getFullPathName();
+    const int64 modified = directory.getLastModificationTime().toMilliseconds();
+
+    Array<File> subdirectories;
+    Array<Track> tracks;
+
+    auto cachedTime = cachedDirectoryTimes.find(path);
+    auto cachedList = cachedTracks.find(path);
+
+    if (cachedTime != cachedDirectoryTimes.end() && cachedTime->second == modified) {
+        // Nothing has been added, removed or renamed in here since the cache was written
+        auto cachedChildren = cachedSubdirectories.find(path);
+        if (cachedChildren != cachedSubdirectories.end()) {
+            subdirectories = cachedChildren->second;
+        }
+        if (cachedList != cachedTracks.end()) {
+            tracks = cachedList->second;
+        }
+    }
+    else {
+        // Tracks that were here before keep their cached length, only new ones are opened
+        std::unordered_map<String, double> cachedLengths;
+        if (cachedList != cachedTracks.end()) {
+            for (auto& track : cachedList->second) {
+                cachedLengths[track.file.getFullPathName()] = track.lengthInSeconds;
+            }
+        }
+
+        for (const auto& entry : RangedDirectoryIterator(directory, false, "*",
+                                                         File::findFilesAndDirectories | File::ignoreHiddenFiles)) {
+            const File file = entry.getFile();
+            if (entry.isDirectory()) {
+                if (!file.isSymbolicLink()) {
+                    subdirectories.add(file);
+                }
+            }
+            else if (isAudioFile(file)) {
+                // Opening a new track can take a while, so a stopping thread does not wait for the rest
+                if (threadShouldExit()) {
+                    return;
+                }
+                auto cachedLength = cachedLengths.find(file.getFullPathName());
+                tracks.add({ file, cachedLength != cachedLengths.end() ? cachedLength->second
+                                                                       : decoders->getLengthInSeconds(file) });
+            }
+        }
+    }
+
+    {
+        const ScopedLock sl(resultLock);
+        directoriesFound[path] = modified;
+        for (auto& track : tracks) {
+            tracksFound[track.file.getFullPathName()] = track.lengthInSeconds;
+        }
+    }
+
+    for (auto& subdirectory : subdirectories) {
+        onSubdirectory(subdirectory);
+    }
+}
+
+void LibraryWatcher::addPath(const File& file, bool isDirectory, Changes& changes)
+{
+    if (isDirectory) {
+        // A folder that appears is scanned on this thread, with its watches added as it goes
+        CriticalSection resultLock;
+        std::unordered_map<String, double> tracksFound;
+        std::unordered_map<String, int64> directoriesFound;
+
+        std::function<void(const File&)> scanSubtree;
+        scanSubtree = [&](const File& directory) {
+            scanDirectory(directory, scanSubtree, resultLock, tracksFound, directoriesFound);
+        };
+        scanSubtree(file);
+
+        for (auto& track : tracksFound) {
+            if (known.find(track.first) == known.end()) {
+                known[track.first] = track.second;
+                changes.added.add({ File(track.first), track.second });
+            }
+        }
+        for (auto& directory : directoriesFound) {
+            directoryTimes[directory.first] = directory.second;
+        }
+        return;
+    }
+
+    const String path = file.getFullPathName();
+    if (!isAudioFile(file) || known.find(path) != known.end()) {
+        return;
+    }
+
+    const double length = decoders->getLengthInSeconds(file);
+    known[path] = length;
+    changes.added.add({ file, length });
+}
+
+void LibraryWatcher::removePath(const File& file, Changes& changes)
+{
+    const String path = file.getFullPathName();
+
+    auto track = known.find(path);
+    if (track != known.end()) {
+        known.erase(track);
+        changes.removed.add(file);
+        return;
+    }
+
+    // Otherwise it was a folder, and everything that was in it goes
+    const String prefix = path + File::getSeparatorString();
+    for (auto it = known.begin(); it != known.end();) {
+        if (it->first.startsWith(prefix)) {
+            changes.removed.add(File(it->first));
+            it = known.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    for (auto it = directoryTimes.begin(); it != directoryTimes.end();) {
+        if (it->first == path || it->first.startsWith(prefix)) {
+            it = directoryTimes.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void LibraryWatcher::movePath(const File& from, const File& to, bool isDirectory, Changes& changes)
+{
+    const String fromPath = from.getFullPathName();
+    const String toPath = to.getFullPathName();
+
+    if (!isDirectory) {
+        auto track = known.find(fromPath);
+        if (track == known.end()) {
+            addPath(to, false, changes);
+            return;
+        }
+
+        // A rename keeps the length, unless the new name is not a track any more
+        const double length = track->second;
+        known.erase(track);
+        if (isAudioFile(to)) {
+            known[toPath] = length;
+            changes.moved.add({ from, to });
+        }
+        else {
+            changes.removed.add(from);
+        }
+        return;
+    }
+
+    if (directoryTimes.find(fromPath) == directoryTimes.end()) {
+        addPath(to, true, changes);
+        return;
+    }
+
+    // Renaming a folder renames every track and folder under it, without listing anything
+    const String prefix = fromPath + File::getSeparatorString();
+    auto renamed = [&](const String& path) { return toPath + path.substring(fromPath.length()); };
+
+    Array<Track> movedTracks;
+    for (auto it = known.begin(); it != known.end();) {
+        if (it->first.startsWith(prefix)) {
+            movedTracks.add({ File(it->first), it->second });
+            it = known.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    for (auto& track : movedTracks) {
+        const String newPath = renamed(track.file.getFullPathName());
+        known[newPath] = track.lengthInSeconds;
+        changes.moved.add({ track.file, File(newPath) });
+    }
+
+    std::unordered_map<String, int64> movedDirectories;
+    for (auto it = directoryTimes.begin(); it != directoryTimes.end();) {
+        if (it->first == fromPath || it->first.startsWith(prefix)) {
+            movedDirectories[renamed(it->first)] = it->second;
+            it = directoryTimes.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    directoryTimes.insert(movedDirectories.begin(), movedDirectories.end());
+
+   #if JUCE_LINUX
+    // The kernel keeps watching the moved folders, only their paths change
+    const ScopedLock sl(watchLock);
+    for (auto& watch : watches) {
+        if (watch.second == fromPath || watch.second.startsWith(prefix)) {
+            watch.second = renamed(watch.second);
+        }
+    }
+   #endif
+}
+
+bool LibraryWatcher::isAudioFile(const File& file) const
+{
+    return decoders->getFormatManager().findFormatForFileExtension(file.getFileExtension()) != nullptr;
+}
+
+void LibraryWatcher::post(Changes changes)
+{
+    if (changes.isEmpty()) {
+        return;
+    }
+
+    const ScopedLock sl(pendingLock);
+    pending.add(std::move(changes));
+    triggerAsyncUpdate();
+}
+
+void LibraryWatcher::loadFolders()
+{
+    // Reading the watched folders from WatchFolders.txt
+    std::ifstream file("WatchFolders.txt");
+    std::string line;
+
+    const ScopedLock sl(folderLock);
+    while (std::getline(file, line)) {
+        File folder(String(line));
+        if (line.size() > 0 && folder.isDirectory()) {
+            folders.addIfNotAlreadyThere(folder);
+        }
+    }
+}
+
+void LibraryWatcher::saveFolders() const
+{
+    // Writing the watched folders to WatchFolders.txt
+    std::ofstream file("WatchFolders.txt");
+    for (auto& folder : getFolders()) {
+        file << folder.getFullPathName() << std::endl;
+    }
+}
+
+void LibraryWatcher::loadCache()
+{
+    cachedDirectoryTimes.clear();
+    cachedSubdirectories.clear();
+    cachedTracks.clear();
+
+    // Each line is "D <tab> modification time <tab> path" for a folder or "F <tab> length <tab> path" for a track
+    std::ifstream file("LibraryCache.txt");
+    std::string string;
+    while (std::getline(file, string)) {
+        const String line(CharPointer_UTF8(string.c_str()));
+        const String value = line.fromFirstOccurrenceOf("\t", false, false).upToFirstOccurrenceOf("\t", false, false);
+        const String path = line.fromFirstOccurrenceOf("\t", false, false).fromFirstOccurrenceOf("\t", false, false);
+        if (path.isEmpty()) {
+            continue;
+        }
+
+        const File entry(path);
+        const String parent = entry.getParentDirectory().getFullPathName();
+
+        if (line.startsWith("D\t")) {
+            cachedDirectoryTimes[path] = value.getLargeIntValue();
+            cachedSubdirectories[parent].add(entry);
+        }
+        else if (line.startsWith("F\t")) {
+            cachedTracks[parent].add({ entry, value.getDoubleValue() });
+        }
+    }
+}
+
+void LibraryWatcher::saveCache() const
+{
+    std::ofstream file("LibraryCache.txt");
+    for (auto& directory : directoryTimes) {
+        file << "D\t" << directory.second << "\t" << directory.first.toStdString() << "\n";
+    }
+    for (auto& track : known) {
+        file << "F\t" << String(track.second, 3).toStdString() << "\t" << track.first.toStdString() << "\n";
+    }
+}
+
+#if JUCE_LINUX
+void LibraryWatcher::watchForChanges()
+{
+    const int bufferSize = 65536;
+    HeapBlock<char> buffer(bufferSize);
+
+    while (!threadShouldExit() && !rescanRequested)
+    {
+        pollfd descriptor{ inotifyFd, POLLIN, 0 };
+        if (poll(&descriptor, 1, 250) <= 0) {
+            continue;
+        }
+
+        const ssize_t length = ::read(inotifyFd, buffer.get(), (size_t) bufferSize);
+        if (length <= 0) {
+            continue;
+        }
+
+        Changes changes;
+        std::unordered_map<uint32, std::pair<File, bool>> movedFrom;
+        bool overflowed = false;
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer.get() + offset);
+            offset += (ssize_t) sizeof(inotify_event) + (ssize_t) event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflowed = true;
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                // The folder has gone, and the kernel has dropped its watch
+                const ScopedLock sl(watchLock);
+                watches.erase(event->wd);
+                continue;
+            }
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                // Every other folder is reported by its parent, so only a watched root going is handled here.
+                // A moved root is still watched by the kernel under a path that is not known, so its watches go too
+                String directory;
+                {
+                    const ScopedLock sl(watchLock);
+                    auto watch = watches.find(event->wd);
+                    if (watch == watches.end()) {
+                        continue;
+                    }
+                    directory = watch->second;
+                }
+                if (getFolders().contains(File(directory))) {
+                    removePath(File(directory), changes);
+                    pruneWatches();
+                }
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+
+            String directory;
+            {
+                const ScopedLock sl(watchLock);
+                auto watch = watches.find(event->wd);
+                if (watch == watches.end()) {
+                    continue;
+                }
+                directory = watch->second;
+            }
+
+            const File file = File(directory).getChildFile(String::fromUTF8(event->name));
+            const bool isDirectory = (event->mask & IN_ISDIR) != 0;
+            directoryTimes[directory] = File(directory).getLastModificationTime().toMilliseconds();
+
+            if (event->mask & IN_MOVED_FROM) {
+                // Held until the matching IN_MOVED_TO, which makes it a rename
+                movedFrom[event->cookie] = { file, isDirectory };
+            }
+            else if (event->mask & IN_MOVED_TO) {
+                auto from = movedFrom.find(event->cookie);
+                if (from != movedFrom.end()) {
+                    movePath(from->second.first, file, isDirectory, changes);
+                    movedFrom.erase(from);
+                }
+                else {
+                    addPath(file, isDirectory, changes);
+                }
+            }
+            else if ((event->mask & IN_CREATE) && isDirectory) {
+                addPath(file, true, changes);
+            }
+            else if (event->mask & IN_CLOSE_WRITE) {
+                // New files are added once they have been written, not when they are created
+                addPath(file, false, changes);
+            }
+            else if (event->mask & IN_DELETE) {
+                removePath(file, changes);
+            }
+        }
+
+        // Whatever was moved out of the watched folders has gone from the library
+        for (auto& from : movedFrom) {
+            removePath(from.second.first, changes);
+        }
+        post(std::move(changes));
+
+        // Events were lost, so the folders are scanned again, listing only the folders that changed
+        if (overflowed) {
+            Logger::writeToLog("LibraryWatcher: inotify queue overflowed, scanning again");
+            scanAll();
+        }
+    }
+}
+
+void LibraryWatcher::addWatch(const File& directory)
+{
+    if (inotifyFd < 0) {
+        return;
+    }
+
+    const int wd = inotify_add_watch(inotifyFd, directory.getFullPathName().toRawUTF8(),
+                                     IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+                                     | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+    if (wd < 0) {
+        Logger::writeToLog("LibraryWatcher: could not watch " + directory.getFullPathName()
+                           + ", fs.inotify.max_user_watches may need raising");
+        return;
+    }
+
+    const ScopedLock sl(watchLock);
+    watches[wd] = directory.getFullPathName();
+}
+
+void LibraryWatcher::pruneWatches()
+{
+    // Folders the library no longer has, after a root was removed or went away, stop being watched
+    const ScopedLock sl(watchLock);
+    for (auto it = watches.begin(); it != watches.end();) {
+        if (directoryTimes.find(it->second) == directoryTimes.end()) {
+            inotify_rm_watch(inotifyFd, it->first);
+            it = watches.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+#endif
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.h
+    Created: 20 Oct 2026 11:42:15am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <unordered_map>
+#include "DecoderService.h"
+
+//==============================================================================
+/*
+    Keeps the library in step with a set of watched folders.
+
+    When it starts, the folders are scanned recursively with one job per
+    directory on a thread pool. Every directory's modification time and
+    tracks are kept in LibraryCache.txt, and a directory whose time has not
+    changed since the last run is taken from the cache without being listed
+    or having its tracks opened. Adding or removing a folder wakes the thread
+    to scan again the same way. After the scan, inotify reports files and
+    folders being added, removed and renamed, so the library is updated
+    without scanning again. Other platforms only get the scans.
+
+    Changes are handed to the callback on the message thread, in the order
+    they happened.
+*/
+class LibraryWatcher  : private Thread,
+                        private AsyncUpdater
+{
+public:
+    struct Track
+    {
+        File file;
+        double lengthInSeconds = 0;
+    };
+
+    struct Move
+    {
+        File from;
+        File to;
+    };
+
+    // A batch of changes to the tracks in the watched folders
+    struct Changes
+    {
+        Array<Track> added;
+        Array<File> removed;
+        Array<Move> moved;
+
+        bool isEmpty() const { return added.isEmpty() && removed.isEmpty() && moved.isEmpty(); }
+    };
+
+    LibraryWatcher(std::function<void(const Changes&)> onLibraryChanged);
+    ~LibraryWatcher() override;
+
+    /** start watching a folder, its tracks are added once it has been scanned */
+    void addFolder(const File& folder);
+    /** stop watching a folder, its tracks are removed from the library */
+    void removeFolder(const File& folder);
+    Array<File> getFolders() const;
+
+    /** true if a file is inside one of the watched folders */
+    bool isInWatchedFolder(const File& file) const;
+
+private:
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    // Function to scan every watched folder and report how the tracks differ from what the library has
+    void scanAll();
+
+    // Function to list one directory, from the cache when it has not changed, calling back for each subdirectory
+    void scanDirectory(const File& directory, std::function<void(const File&)> onSubdirectory,
+                       CriticalSection& resultLock, std::unordered_map<String, double>& tracksFound,
+                       std::unordered_map<String, int64>& directoriesFound);
+
+    // Functions to update the library for a file or folder that was added, removed or renamed
+    void addPath(const File& file, bool isDirectory, Changes& changes);
+    void removePath(const File& file, Changes& changes);
+    void movePath(const File& from, const File& to, bool isDirectory, Changes& changes);
+
+    bool isAudioFile(const File& file) const;
+
+    // Function to queue a batch of changes for the message thread
+    void post(Changes changes);
+
+    void loadFolders();
+    void saveFolders() const;
+    void loadCache();
+    void saveCache() const;
+
+   #if JUCE_LINUX
+    // Function to read inotify events until the thread is stopped or asked to scan again
+    void watchForChanges();
+    void addWatch(const File& directory);
+
+    // Function to stop watching the directories that are no longer in the library
+    void pruneWatches();
+
+    int inotifyFd = -1;
+    CriticalSection watchLock;
+    std::unordered_map<int, String> watches;
+   #endif
+
+    std::function<void(const Changes&)> onChange;
+    SharedResourcePointer<DecoderService> decoders;
+
+    mutable CriticalSection folderLock;
+    Array<File> folders;
+
+    // Set when a folder is added or removed, the thread then scans again
+    std::atomic<bool> rescanRequested{ false };
+
+    // Only used by the watcher thread: the tracks the library has been told about, and the directories they are in
+    std::unordered_map<String, double> known;
+    std::unordered_map<String, int64> directoryTimes;
+
+    // What the last run left in LibraryCache.txt, read only while scanning
+    std::unordered_map<String, int64> cachedDirectoryTimes;
+    std::unordered_map<String, Array<File>> cachedSubdirectories;
+    std::unordered_map<String, Array<Track>> cachedTracks;
+
+    CriticalSection pendingLock;
+    Array<Changes> pending;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryWatcher)
+};
@@ -8,6 +8,7 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "Tracer.h"
 
 //==============================================================================
 class OtoDecks_End_Term_AssignmentApplication  : public juce::JUCEApplication
@@ -25,7 +26,15 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
-        mainWindow.reset (new MainWindow (getApplicationName()));
+        // Startup is timed from here to the window's first frame
+        const int64 launchTicks = Time::getHighResolutionTicks();
+
+        // Tracing from the very start, so a slow startup can be looked at
+        if (commandLine.contains("--trace")) {
+            Tracer::setEnabled(true);
+        }
+
+        mainWindow.reset (new MainWindow (getApplicationName(), launchTicks));
     }
 
     void shutdown() override
@@ -33,6 +42,12 @@ public:
         // Add your application's shutdown code here..
 
         mainWindow = nullptr; // (deletes our window)
+
+        // Writing out a trace that is still running when the application closes
+        if (Tracer::isEnabled()) {
+            Tracer::setEnabled(false);
+            Tracer::writeTo(File::getCurrentWorkingDirectory().getChildFile("OtoDecksTrace.json"));
+        }
     }
 
     //==============================================================================
@@ -58,14 +73,14 @@ public:
     class MainWindow    : public juce::DocumentWindow
     {
     public:
-        MainWindow (juce::String name)
+        MainWindow (juce::String name, int64 launchTicks)
             : DocumentWindow (name,
                               juce::Desktop::getInstance().getDefaultLookAndFeel()
                                                           .findColour (juce::ResizableWindow::backgroundColourId),
                               DocumentWindow::allButtons)
         {
             setUsingNativeTitleBar (true);
-            setContentOwned (new MainComponent(), true);
+            setContentOwned (new MainComponent (launchTicks), true);
 
            #if JUCE_IOS || JUCE_ANDROID
             setFullScreen (true);
@@ -1,47 +1,130 @@
 #include "MainComponent.h"
+#include "Tracer.h"
+#include "RealtimeGuard.h"
 
 //==============================================================================
-MainComponent::MainComponent() : playlistComponent()
+MainComponent::MainComponent(int64 launchTicks) : playlistComponent(), launchTicks(launchTicks)
 {
+    TraceSpan span("MainComponent::MainComponent");
+
     // Make sure you set the size of the component after
     // you add any child components.
     setSize (800, 600);
 
-    // Some platforms require permissions to open input channels so request that here
-    if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
-        && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
-    {
-        juce::RuntimePermissions::request (juce::RuntimePermissions::recordAudio,
-                                           [&] (bool granted) { if (granted)  setAudioChannels(2, 2); });
-    }
-    else
-    {
-        // Specify the number of input and output channels that we want to open
-        setAudioChannels (0, 2);
-    }
-
-    formatManager.registerBasicFormats();
+    // The decks are timed from their first block, so the monitor is given to them before the audio starts
+    player1.setMonitor(&callbackMonitor, 1);
+    player2.setMonitor(&callbackMonitor, 2);
+    callbackMonitor.setDeviceManager(&deviceManager);
 
     addAndMakeVisible(deckGUI1);
     addAndMakeVisible(deckGUI2);
 
     addAndMakeVisible(playlistComponent);
+    addAndMakeVisible(masterDisplay);
+    addAndMakeVisible(samplerComponent);
+
+    addChildComponent(performanceOverlay);
+    setWantsKeyboardFocus(true);
 
     // Setting playlist component to use this instance of main component
     playlistComponent.selectMainComponent(this);
+
+    // The library's key filter follows whatever is loaded on the decks
+    deckGUI1.onTrackLoaded = [this] { playlistComponent.deckTrackChanged(1); };
+    deckGUI2.onTrackLoaded = [this] { playlistComponent.deckTrackChanged(2); };
+
+    // The displays stop updating while nothing plays, and are woken by whatever may start the audio again
+    player1.onWake = [this] { deckGUI1.wake(); masterDisplay.wake(); };
+    player2.onWake = [this] { deckGUI2.wake(); masterDisplay.wake(); };
+    samplerComponent.onPadTriggered = [this] { masterDisplay.wake(); };
+
+    // The audio device and the caches are left until the window has drawn its first frame
+    firstFrameAttachment = std::make_unique<VBlankAttachment>(this, [this] { firstFrameShown(); });
 }
 
 MainComponent::~MainComponent()
 {
+    masterRecorder.stopRecording();
+
+    // The settings window shows the device manager, so it is closed first
+    if (audioSettingsWindow != nullptr) {
+        delete audioSettingsWindow.getComponent();
+    }
+    deviceManager.removeChangeListener(this);
+
     // This shuts down the audio device and clears the audio source.
     shutdownAudio();
+    callbackMonitor.setDeviceManager(nullptr);
+}
+
+//==============================================================================
+void MainComponent::firstFrameShown()
+{
+    if (startupFinished) {
+        return;
+    }
+    startupFinished = true;
+
+    const int64 firstFrameTicks = Time::getHighResolutionTicks();
+    if (Tracer::isEnabled()) {
+        Tracer::record("Startup to first frame", launchTicks, firstFrameTicks);
+    }
+
+    // The rest is done after this frame, and the attachment cannot be deleted from inside its own callback
+    Component::SafePointer<MainComponent> safeThis(this);
+    MessageManager::callAsync([safeThis, firstFrameTicks] {
+        if (safeThis == nullptr) {
+            return;
+        }
+        safeThis->firstFrameAttachment = nullptr;
+
+        {
+            TraceSpan span("Startup after first frame");
+            safeThis->openAudioDevice();
+            safeThis->playlistComponent.warmUpCaches();
+        }
+
+        const double firstFrameMs = Time::highResolutionTicksToSeconds(firstFrameTicks - safeThis->launchTicks) * 1000.0;
+        const double readyMs = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - safeThis->launchTicks) * 1000.0;
+        Logger::writeToLog("Startup: first frame after " + String(firstFrameMs, 1) + "ms, audio device open and caches loaded after "
+                           + String(readyMs, 1) + "ms");
+    });
+}
+
+void MainComponent::openAudioDevice()
+{
+    // Opening the device with the settings saved from the last run
+    std::unique_ptr<XmlElement> savedSettings = XmlDocument::parse(File::getCurrentWorkingDirectory().getChildFile("AudioSettings.xml"));
+
+    // Some platforms require permissions to open input channels so request that here
+    if (juce::RuntimePermissions::isRequired (juce::RuntimePermissions::recordAudio)
+        && ! juce::RuntimePermissions::isGranted (juce::RuntimePermissions::recordAudio))
+    {
+        juce::RuntimePermissions::request (juce::RuntimePermissions::recordAudio,
+                                           [&] (bool granted) { if (granted)  setAudioChannels(2, 2); });
+    }
+    else
+    {
+        // Specify the number of input and output channels that we want to open
+        setAudioChannels (0, 2, savedSettings.get());
+    }
+    deviceManager.addChangeListener(this);
 }
 
 //==============================================================================
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
+    // The audio thread's trace ring is made here, so its first span does not allocate in the callback
+    Tracer::prepareRealtimeThread();
+
     player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
     player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    autoDJ.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    midiRouter.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    callbackMonitor.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    masterRecorder.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    samplerBank.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    masterAnalyser.prepareToPlay(sampleRate);
 
     mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
 
@@ -51,7 +134,39 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    mixerSource.getNextAudioBlock(bufferToFill);
+    // In debug builds anything in the callback that allocates or locks is reported
+    RealtimeGuard::ScopedRealtime realtime;
+    Tracer::claimRealtimeBuffer();
+    AudioCallbackMonitor::ScopedTimer timer(&callbackMonitor, 0, bufferToFill.numSamples);
+    TraceSpan span("MainComponent::getNextAudioBlock");
+
+    // Controller messages from the last block are handed to the decks with the sample each one lands on
+    midiRouter.processBlock(bufferToFill.numSamples);
+
+    // The auto DJ starts the next deck before the decks are rendered so it can start on any sample of this block
+    autoDJ.processBlock(bufferToFill.numSamples);
+
+    // When both decks are stopped the mix is silence, so it is cleared once instead of going through the mixer
+    const bool decksIdle = player1.isIdle() && player2.isIdle();
+    if (decksIdle) {
+        bufferToFill.clearActiveBufferRegion();
+        player1.skipBlock();
+        player2.skipBlock();
+    }
+    else {
+        mixerSource.getNextAudioBlock(bufferToFill);
+    }
+
+    // The pads are mixed in on top of the decks
+    samplerBank.process(bufferToFill);
+
+    // The recorder only copies the mix into its FIFO, the file is written on its own thread
+    masterRecorder.process(bufferToFill);
+
+    // Only the levels are measured here, the spectrum is worked out on the message thread
+    if (!decksIdle || !samplerBank.isSilent()) {
+        masterAnalyser.pushBlock(bufferToFill);
+    }
 }
 
 void MainComponent::releaseResources()
@@ -75,16 +190,133 @@ void MainComponent::resized()
     deckGUI1.setBounds(0, 0, getWidth() / 2, getHeight() / 2);
     deckGUI2.setBounds(getWidth() / 2, 0, getWidth() / 2, getHeight() / 2);
 
-    playlistComponent.setBounds(0, getHeight() / 2, getWidth(), getHeight() / 2);
+    // The sampler pads and the master meters and spectrum sit in a strip between the decks and the playlist
+    const int masterH = getHeight() / 12;
+    samplerComponent.setBounds(0, getHeight() / 2, getWidth() / 2, masterH);
+    masterDisplay.setBounds(getWidth() / 2, getHeight() / 2, getWidth() - getWidth() / 2, masterH);
+    playlistComponent.setBounds(0, getHeight() / 2 + masterH, getWidth(), getHeight() / 2 - masterH);
+
+    performanceOverlay.setBounds(10, 10, getWidth() - 20, 120);
+}
+
+bool MainComponent::keyPressed(const KeyPress& key)
+{
+    if (key == KeyPress::F12Key) {
+        performanceOverlay.setVisible(!performanceOverlay.isVisible());
+        performanceOverlay.toFront(false);
+        return true;
+    }
+
+    // F11 starts a trace, and pressing it again writes everything recorded to OtoDecksTrace.json
+    if (key == KeyPress::F11Key) {
+        if (Tracer::isEnabled()) {
+            Tracer::setEnabled(false);
+            File traceFile = File::getCurrentWorkingDirectory().getChildFile("OtoDecksTrace.json");
+            if (Tracer::writeTo(traceFile)) {
+                DBG("Trace written to " + traceFile.getFullPathName());
+            }
+        }
+        else {
+            Tracer::setEnabled(true);
+        }
+        return true;
+    }
+    return false;
 }
 
 void MainComponent::deckGUIPlay(URL track, int deck)
 {
+    // Using the reader opened by the preloader when the track has already been warmed up
+    std::unique_ptr<AudioFormatReader> reader;
+    if (track.isLocalFile()) {
+        reader = preloader.takeReader(track.getLocalFile());
+    }
+
     // Calling the function in deckGUI based on what deck was chosen to load the track
     if (deck == 1) {
-        deckGUI1.play(track);
+        deckGUI1.play(track, reader.release());
+    }
+    if (deck == 2) {
+        deckGUI2.play(track, reader.release());
+    }
+}
+
+File MainComponent::getDeckTrack(int deck) const
+{
+    if (deck == 1) {
+        return deckGUI1.getLoadedTrack();
     }
     if (deck == 2) {
-        deckGUI2.play(track);
+        return deckGUI2.getLoadedTrack();
+    }
+    return {};
+}
+
+void MainComponent::preloadTracks(const Array<File>& tracks)
+{
+    preloader.preload(tracks);
+}
+
+void MainComponent::startAutoDJ(const Array<File>& tracks)
+{
+    autoDJ.start(tracks);
+}
+
+void MainComponent::stopAutoDJ()
+{
+    autoDJ.stop();
+}
+
+bool MainComponent::isAutoDJRunning() const
+{
+    return autoDJ.isRunning();
+}
+
+void MainComponent::startRecording(bool asFlac)
+{
+    File folder = File::getSpecialLocation(File::userMusicDirectory).getChildFile("OtoDecks Recordings");
+    folder.createDirectory();
+
+    String name = "Set " + Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S");
+    File recording = folder.getNonexistentChildFile(name, asFlac ? ".flac" : ".wav");
+    if (!masterRecorder.startRecording(recording)) {
+        DBG("Could not record to " + recording.getFullPathName());
+    }
+}
+
+void MainComponent::stopRecording()
+{
+    masterRecorder.stopRecording();
+}
+
+bool MainComponent::isRecording() const
+{
+    return masterRecorder.isRecording();
+}
+
+void MainComponent::showAudioSettings()
+{
+    if (audioSettingsWindow != nullptr) {
+        audioSettingsWindow->toFront(true);
+        return;
+    }
+
+    DialogWindow::LaunchOptions options;
+    options.content.setOwned(new AudioSettingsComponent(deviceManager, callbackMonitor, midiRouter));
+    options.dialogTitle = "Audio Settings";
+    options.dialogBackgroundColour = Colours::black;
+    options.escapeKeyTriggersCloseButton = true;
+    options.useNativeTitleBar = true;
+    options.resizable = false;
+    audioSettingsWindow = options.launchAsync();
+}
+
+void MainComponent::changeListenerCallback(ChangeBroadcaster* source)
+{
+    // Saving the backend, device, sample rate and buffer size so they are used again next time
+    if (source == &deviceManager) {
+        if (auto settings = deviceManager.createStateXml()) {
+            settings->writeTo(File::getCurrentWorkingDirectory().getChildFile("AudioSettings.xml"));
+        }
     }
 }
\ No newline at end of file
@@ -4,17 +4,30 @@
 #include "DJAudioPlayer.h"
 #include "DeckGUI.h"
 #include "PlaylistComponent.h"
+#include "TrackPreloader.h"
+#include "DecoderService.h"
+#include "HotCueLibrary.h"
+#include "AutoDJ.h"
+#include "AudioCallbackMonitor.h"
+#include "PerformanceOverlay.h"
+#include "AudioSettingsComponent.h"
+#include "MasterRecorder.h"
+#include "AnalyserDisplay.h"
+#include "MidiRouter.h"
+#include "SamplerComponent.h"
 
 //==============================================================================
 /*
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent  : public juce::AudioAppComponent
+class MainComponent  : public juce::AudioAppComponent,
+                       public ChangeListener
 {
 public:
     //==============================================================================
-    MainComponent();
+    /** launchTicks is the high resolution tick count when the application started, used to time the startup */
+    MainComponent(int64 launchTicks);
     ~MainComponent() override;
 
     //==============================================================================
@@ -26,24 +39,84 @@ public:
     void paint (juce::Graphics& g) override;
     void resized() override;
 
+    // Function to show or hide the audio callback timings with F12, and to start or write a trace with F11
+    bool keyPressed(const KeyPress& key) override;
+
     void deckGUIPlay(URL track, int deck);
 
+    // Function to get the track loaded on deck 1 or 2, or File() when there is none
+    File getDeckTrack(int deck) const;
+
+    // Function to warm up tracks in the background before they are added to a deck
+    void preloadTracks(const Array<File>& tracks);
+
+    // Functions to play through a queue of tracks on the two decks
+    void startAutoDJ(const Array<File>& tracks);
+    void stopAutoDJ();
+    bool isAutoDJRunning() const;
+
+    // Functions to record the master output to a file in the music folder
+    void startRecording(bool asFlac);
+    void stopRecording();
+    bool isRecording() const;
+
+    // Function to open the window for choosing the audio device and buffer size
+    void showAudioSettings();
+
+    // Function to save the audio device settings whenever they change
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
 private:
+    // Function to report the time to the first frame, then open the audio device and warm up the caches
+    void firstFrameShown();
+
+    // Function to open the audio device with the settings saved from the last run
+    void openAudioDevice();
+
     //==============================================================================
     // Your private member variables go here...
 
-    AudioFormatManager formatManager;
+    // Every track is opened through the shared decoder service
+    SharedResourcePointer<DecoderService> decoders;
+    AudioFormatManager& formatManager{ decoders->getFormatManager() };
+
+    // Section 0 is the whole callback, followed by one section for each deck
+    AudioCallbackMonitor callbackMonitor{ StringArray{ "callback", "deck 1", "deck 2" } };
+    PerformanceOverlay performanceOverlay{ callbackMonitor };
     AudioThumbnailCache thumbCache{ 100 };
 
-    DJAudioPlayer player1{ formatManager };
-    DeckGUI deckGUI1{ &player1, formatManager, thumbCache };
+    TrackPreloader preloader{ formatManager, thumbCache };
+    HotCueLibrary hotCueLibrary;
 
+    DJAudioPlayer player1{ formatManager };
     DJAudioPlayer player2{ formatManager };
-    DeckGUI deckGUI2{ &player2, formatManager, thumbCache };
+
+    // MIDI controllers reach the decks on the audio thread, without going through the message thread
+    MidiRouter midiRouter{ deviceManager, player1, player2 };
+
+    DeckGUI deckGUI1{ &player1, formatManager, thumbCache, hotCueLibrary, midiRouter, 0 };
+    DeckGUI deckGUI2{ &player2, formatManager, thumbCache, hotCueLibrary, midiRouter, 1 };
+
+    AutoDJ autoDJ{ player1, player2, [this](URL track, int deck) { deckGUIPlay(track, deck); } };
 
     MixerAudioSource mixerSource;
+    MasterRecorder masterRecorder;
+
+    // One-shots fired over the decks, mixed into the master in the same callback
+    SamplerBank samplerBank;
+    SamplerComponent samplerComponent{ samplerBank };
+
+    AudioAnalyser masterAnalyser;
+    AnalyserDisplay masterDisplay{ masterAnalyser };
 
     PlaylistComponent playlistComponent;
 
+    Component::SafePointer<DialogWindow> audioSettingsWindow;
+
+    // Startup is timed from launch to the first display frame, which is waited for with a one-off attachment
+    const int64 launchTicks;
+    bool startupFinished = false;
+    std::unique_ptr<VBlankAttachment> firstFrameAttachment;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
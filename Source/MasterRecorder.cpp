@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.cpp
+    Created: 19 Oct 2026 8:51:05pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "MasterRecorder.h"
+
+//==============================================================================
+MasterRecorder::MasterRecorder() : Thread("Master recorder")
+{
+}
+
+MasterRecorder::~MasterRecorder()
+{
+    stopRecording();
+}
+
+void MasterRecorder::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    // A file cannot change its sample rate, so a recording ends when the device does
+    if (isRecording() && newSampleRate != sampleRate) {
+        stopRecording();
+    }
+    sampleRate = newSampleRate;
+}
+
+bool MasterRecorder::startRecording(const File& fileToRecord)
+{
+    stopRecording();
+
+    if (sampleRate <= 0) {
+        return false;
+    }
+
+    fileToRecord.deleteFile();
+    std::unique_ptr<FileOutputStream> stream(fileToRecord.createOutputStream());
+    if (stream == nullptr) {
+        return false;
+    }
+
+    WavAudioFormat wav;
+    FlacAudioFormat flac;
+    AudioFormat& format = fileToRecord.hasFileExtension(".flac") ? (AudioFormat&) flac : (AudioFormat&) wav;
+
+    writer.reset(format.createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0));
+    if (writer == nullptr) {
+        return false;
+    }
+    stream.release();
+
+    // The audio thread is not using the FIFO while nothing is recording, so it can be set up here
+    const int fifoSize = roundToInt(fifoSeconds * sampleRate);
+    fifoBuffer.setSize(2, fifoSize);
+    fifo.setTotalSize(fifoSize);
+    fifo.reset();
+
+    file = fileToRecord;
+    droppedSamples = 0;
+    writtenSamples = 0;
+
+    startThread(Thread::Priority::normal);
+    recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void MasterRecorder::stopRecording()
+{
+    if (!recording.exchange(false)) {
+        return;
+    }
+
+    // Waiting for a block that the audio thread may still be copying
+    while (processing.load()) {
+        Thread::yield();
+    }
+
+    // The writer thread writes out what is left in the FIFO before it stops
+    stopThread(10000);
+    writer.reset();
+
+    DBG("Recorded " + String(getRecordedSeconds(), 1) + "s to " + file.getFullPathName()
+        + ", dropped " + String(getDroppedSamples()) + " samples");
+}
+
+bool MasterRecorder::isRecording() const
+{
+    return recording.load();
+}
+
+File MasterRecorder::getFile() const
+{
+    return file;
+}
+
+double MasterRecorder::getRecordedSeconds() const
+{
+    return sampleRate > 0 ? writtenSamples.load() / sampleRate : 0.0;
+}
+
+int64 MasterRecorder::getDroppedSamples() const
+{
+    return droppedSamples.load();
+}
+
+void MasterRecorder::process(const AudioSourceChannelInfo& bufferToFill)
+{
+    processing = true;
+
+    if (recording.load()) {
+        const int numSamples = bufferToFill.numSamples;
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        if (size1 + size2 < numSamples) {
+            // The writer is too far behind, so this block is dropped rather than waited for
+            droppedSamples.fetch_add(numSamples, std::memory_order_relaxed);
+        }
+        else {
+            const auto& source = *bufferToFill.buffer;
+            const int numSourceChannels = source.getNumChannels();
+            for (int channel = 0; channel < 2 && numSourceChannels > 0; ++channel) {
+                const int sourceChannel = jmin(channel, numSourceChannels - 1);
+                fifoBuffer.copyFrom(channel, start1, source, sourceChannel, bufferToFill.startSample, size1);
+                if (size2 > 0) {
+                    fifoBuffer.copyFrom(channel, start2, source, sourceChannel, bufferToFill.startSample + size1, size2);
+                }
+            }
+            fifo.finishedWrite(size1 + size2);
+        }
+    }
+
+    processing = false;
+}
+
+void MasterRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        drain();
+        wait(20);
+    }
+    drain();
+}
+
+void MasterRecorder::drain()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    if (size1 > 0) {
+        writer->writeFromAudioSampleBuffer(fifoBuffer, start1, size1);
+    }
+    if (size2 > 0) {
+        writer->writeFromAudioSampleBuffer(fifoBuffer, start2, size2);
+    }
+
+    fifo.finishedRead(size1 + size2);
+    writtenSamples += size1 + size2;
+}
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.h
+    Created: 19 Oct 2026 8:51:05pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Records the master output to a WAV or FLAC file.
+
+    The audio thread only copies each block into a fixed size FIFO, without
+    locking, allocating or waking any thread. A writer thread drains the FIFO
+    into the file every few milliseconds. If the writer falls so far behind
+    that the FIFO is full, the block is dropped and counted rather than making
+    the audio thread wait.
+*/
+class MasterRecorder  : private Thread
+{
+public:
+    MasterRecorder();
+    ~MasterRecorder() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /** start recording to a file, as FLAC if it ends in .flac and as WAV otherwise */
+    bool startRecording(const File& file);
+    void stopRecording();
+    bool isRecording() const;
+
+    /** get the file being recorded, or the last one that was */
+    File getFile() const;
+
+    /** get the seconds written to the file so far */
+    double getRecordedSeconds() const;
+
+    /** get the number of samples dropped because the FIFO was full */
+    int64 getDroppedSamples() const;
+
+    /** copy the master output into the FIFO, called on the audio thread */
+    void process(const AudioSourceChannelInfo& bufferToFill);
+
+private:
+    void run() override;
+
+    // Function to write everything waiting in the FIFO to the file
+    void drain();
+
+    // Seconds of audio the FIFO can hold before blocks are dropped
+    static constexpr double fifoSeconds = 5.0;
+
+    AbstractFifo fifo{ 1 };
+    AudioBuffer<float> fifoBuffer;
+
+    std::unique_ptr<AudioFormatWriter> writer;
+    File file;
+    double sampleRate = 0;
+
+    std::atomic<bool> recording{ false };
+    std::atomic<bool> processing{ false };
+    std::atomic<int64> droppedSamples{ 0 };
+    std::atomic<int64> writtenSamples{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MasterRecorder)
+};
@@ -0,0 +1,400 @@
+/*
+  ==============================================================================
+
+    MidiRouter.cpp
+    Created: 20 Oct 2026 6:20:03pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <fstream>
+#include "MidiRouter.h"
+
+//==============================================================================
+namespace
+{
+    // How far a controller mapped to speed moves it either side of normal, like a pitch fader
+    const double pitchRange = 0.08;
+
+    const char* kindNames[] = { "note", "cc", "pitch" };
+}
+
+//==============================================================================
+MidiRouter::MidiRouter(AudioDeviceManager& deviceManagerToUse, DJAudioPlayer& deck1, DJAudioPlayer& deck2)
+                      : deviceManager(deviceManagerToUse)
+{
+    decks[0] = &deck1;
+    decks[1] = &deck2;
+
+    for (auto& entry : table) {
+        entry = 0;
+    }
+    loadMappings();
+
+    // Every MIDI input enabled in the audio settings comes through here
+    deviceManager.addMidiInputDeviceCallback({}, this);
+
+    // A virtual input that other programs can connect to, where the platform has them
+    virtualInput = MidiInput::createNewDevice("OtoDecks Controller", this);
+    if (virtualInput != nullptr) {
+        virtualInput->start();
+    }
+}
+
+MidiRouter::~MidiRouter()
+{
+    setLatencyTest(false);
+    if (virtualInput != nullptr) {
+        virtualInput->stop();
+    }
+    deviceManager.removeMidiInputDeviceCallback({}, this);
+    cancelPendingUpdate();
+}
+
+void MidiRouter::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+}
+
+void MidiRouter::handleIncomingMidiMessage(MidiInput* source, const MidiMessage& message)
+{
+    const double now = Time::getMillisecondCounterHiRes() * 0.001;
+    const double timestamp = message.getTimeStamp() > 0 ? message.getTimeStamp() : now;
+
+    DeckCommand command;
+    if (latencyTest && message.isNoteOn() && message.getChannel() == probeChannel && message.getNoteNumber() == probeNote) {
+        // A probe from the latency test is timed from when it was sent
+        command.timestamp = probeSentAt.load();
+    }
+    else {
+        const int key = getKey(message);
+        if (key < 0) {
+            return;
+        }
+
+        // While learning, the control is handed to the message thread instead of being played
+        if (learnTarget.load() != 0) {
+            if (message.isNoteOn() || message.isController() || message.isPitchWheel()) {
+                learntKey = key;
+                triggerAsyncUpdate();
+            }
+            return;
+        }
+
+        if (!createCommand(message, table[key].load(std::memory_order_relaxed), command)) {
+            return;
+        }
+        command.timestamp = timestamp;
+    }
+
+    // Anything that does not fit in the FIFO is dropped, it only fills if the audio has stopped
+    {
+        const SpinLock::ScopedLockType sl(writeLock);
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        if (size1 > 0) {
+            commands[start1] = command;
+            fifo.finishedWrite(1);
+        }
+    }
+
+    // The command may start or move an idle deck, so its display is woken from here rather than the audio thread
+    if (command.type != DeckCommand::none) {
+        decks[command.deck]->wakeDisplays();
+    }
+}
+
+void MidiRouter::processBlock(int numSamples)
+{
+    if (fifo.getNumReady() == 0) {
+        return;
+    }
+
+    const double now = Time::getMillisecondCounterHiRes() * 0.001;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1 + size2; ++i) {
+        const DeckCommand& command = commands[i < size1 ? start1 + i : start2 + i - size1];
+
+        // A message that arrived during the last block lands at the same point in this one, which keeps
+        // the timing between messages exact for one block of latency. Older messages land on the first sample.
+        const double age = now - command.timestamp;
+        const int offset = jlimit(0, numSamples - 1, numSamples - roundToInt(age * sampleRate));
+        const double latency = age + offset / sampleRate;
+
+        if (command.type == DeckCommand::none) {
+            addLatency(latency, probeCount, probeTotal, probeWorst);
+            continue;
+        }
+
+        addLatency(latency, messageCount, messageTotal, messageWorst);
+        decks[command.deck]->queueCommand(command, offset);
+    }
+
+    fifo.finishedRead(size1 + size2);
+}
+
+void MidiRouter::addLatency(double seconds, std::atomic<int>& count, std::atomic<double>& total, std::atomic<double>& worst)
+{
+    total.store(total.load(std::memory_order_relaxed) + seconds, std::memory_order_relaxed);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    if (seconds > worst.load(std::memory_order_relaxed)) {
+        worst.store(seconds, std::memory_order_relaxed);
+    }
+}
+
+MidiRouter::LatencyStats MidiRouter::getLatencyStats()
+{
+    LatencyStats stats;
+
+    const int messages = messageCount.load(std::memory_order_acquire);
+    const double messageSum = messageTotal.load(std::memory_order_relaxed);
+    stats.messages = messages - lastMessageCount;
+    stats.averageMs = stats.messages > 0 ? (messageSum - lastMessageTotal) * 1000.0 / stats.messages : 0.0;
+    stats.worstMs = messageWorst.exchange(0) * 1000.0;
+    lastMessageCount = messages;
+    lastMessageTotal = messageSum;
+
+    const int probes = probeCount.load(std::memory_order_acquire);
+    const double probeSum = probeTotal.load(std::memory_order_relaxed);
+    stats.probes = probes - lastProbeCount;
+    stats.probeAverageMs = stats.probes > 0 ? (probeSum - lastProbeTotal) * 1000.0 / stats.probes : 0.0;
+    stats.probeWorstMs = probeWorst.exchange(0) * 1000.0;
+    lastProbeCount = probes;
+    lastProbeTotal = probeSum;
+
+    return stats;
+}
+
+void MidiRouter::startLearning(int deck, DeckCommand::Type type, int value)
+{
+    learntKey = -1;
+    learnTarget = packTarget(deck, type, value);
+}
+
+void MidiRouter::cancelLearning()
+{
+    learnTarget = 0;
+}
+
+bool MidiRouter::isLearning(int deck) const
+{
+    const int target = learnTarget.load();
+    return target != 0 && unpackTarget(target).deck == deck;
+}
+
+void MidiRouter::clearMapping(int deck, DeckCommand::Type type, int value)
+{
+    const int target = packTarget(deck, type, value);
+    for (auto& entry : table) {
+        if (entry.load() == target) {
+            entry = 0;
+        }
+    }
+    saveMappings();
+}
+
+String MidiRouter::getMappingDescription(int deck, DeckCommand::Type type, int value) const
+{
+    const int target = packTarget(deck, type, value);
+    for (int key = 0; key < tableSize; ++key) {
+        if (table[key].load() != target) {
+            continue;
+        }
+
+        const int kind = key / (16 * 128);
+        const int channel = (key / 128) % 16 + 1;
+        const int number = key % 128;
+        if (kind == noteKind) {
+            return "Note " + String(number) + " ch " + String(channel);
+        }
+        if (kind == controllerKind) {
+            return "CC " + String(number) + " ch " + String(channel);
+        }
+        return "Pitch bend ch " + String(channel);
+    }
+    return {};
+}
+
+void MidiRouter::setLatencyTest(bool enabled)
+{
+    if (enabled == isLatencyTestRunning()) {
+        return;
+    }
+
+    if (enabled) {
+        probeOutput = MidiOutput::createNewDevice("OtoDecks Latency Probe");
+        if (probeOutput == nullptr) {
+            DBG("Virtual MIDI ports are not available on this platform");
+            return;
+        }
+        latencyTest = true;
+        startTimer(100);
+    }
+    else {
+        stopTimer();
+        latencyTest = false;
+        probeOutput.reset();
+    }
+}
+
+bool MidiRouter::isLatencyTestRunning() const
+{
+    return probeOutput != nullptr;
+}
+
+void MidiRouter::timerCallback()
+{
+    probeSentAt = Time::getMillisecondCounterHiRes() * 0.001;
+    probeOutput->sendMessageNow(MidiMessage::noteOn(probeChannel, probeNote, (uint8) 127));
+}
+
+void MidiRouter::handleAsyncUpdate()
+{
+    const int key = learntKey.exchange(-1);
+    const int target = learnTarget.exchange(0);
+    if (key < 0 || target == 0) {
+        return;
+    }
+
+    // Each command has one control, and each control one command
+    for (auto& entry : table) {
+        if (entry.load() == target) {
+            entry = 0;
+        }
+    }
+    table[key] = target;
+    saveMappings();
+}
+
+int MidiRouter::getKey(const MidiMessage& message)
+{
+    const int channel = message.getChannel() - 1;
+    if (channel < 0 || channel >= 16) {
+        return -1;
+    }
+
+    if (message.isNoteOnOrOff()) {
+        return (noteKind * 16 + channel) * 128 + message.getNoteNumber();
+    }
+    if (message.isController()) {
+        return (controllerKind * 16 + channel) * 128 + message.getControllerNumber();
+    }
+    if (message.isPitchWheel()) {
+        return (pitchBendKind * 16 + channel) * 128;
+    }
+    return -1;
+}
+
+int MidiRouter::packTarget(int deck, DeckCommand::Type type, int value)
+{
+    return ((deck + 1) << 12) | ((value & 15) << 8) | (int) type;
+}
+
+DeckCommand MidiRouter::unpackTarget(int target)
+{
+    DeckCommand command;
+    command.deck = (target >> 12) - 1;
+    command.type = (DeckCommand::Type) (target & 255);
+    command.value = (float) ((target >> 8) & 15);
+    return command;
+}
+
+bool MidiRouter::createCommand(const MidiMessage& message, int target, DeckCommand& command) const
+{
+    if (target == 0) {
+        return false;
+    }
+    command = unpackTarget(target);
+    if (command.deck < 0 || command.deck > 1) {
+        return false;
+    }
+
+    const bool isButton = command.type == DeckCommand::playPause
+                       || command.type == DeckCommand::pause
+                       || command.type == DeckCommand::hotCue;
+
+    // Buttons act when they are pressed, as a note or as a controller going above half way
+    if (isButton) {
+        return message.isNoteOn() || (message.isController() && message.getControllerValue() >= 64);
+    }
+
+    if (message.isController()) {
+        const int value = message.getControllerValue();
+        if (command.type == DeckCommand::gain) {
+            command.value = value / 127.0f;
+        }
+        else if (command.type == DeckCommand::speed) {
+            command.value = (float) (1.0 + pitchRange * jlimit(-1.0, 1.0, (value - 64) / 63.0));
+        }
+        else if (command.type == DeckCommand::jog) {
+            // Jog wheels send how far they moved, 1 to 63 forwards and 127 down to 65 backwards
+            command.value = (float) (value < 64 ? value : value - 128);
+        }
+        return true;
+    }
+
+    if (message.isPitchWheel()) {
+        const int value = message.getPitchWheelValue();
+        if (command.type == DeckCommand::gain) {
+            command.value = value / 16383.0f;
+            return true;
+        }
+        if (command.type == DeckCommand::speed) {
+            command.value = (float) (1.0 + pitchRange * (value - 8192) / 8192.0);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MidiRouter::loadMappings()
+{
+    // Each line is "kind <tab> channel <tab> number <tab> deck <tab> command <tab> value", kind is note, cc or pitch
+    std::ifstream file("MidiMappings.txt");
+    std::string line;
+    while (std::getline(file, line)) {
+        StringArray fields = StringArray::fromTokens(String(line), "\t", "");
+        if (fields.size() != 6) {
+            continue;
+        }
+
+        int kind = 0;
+        while (kind < numKinds && fields[0] != kindNames[kind]) {
+            ++kind;
+        }
+        int type = DeckCommand::none + 1;
+        while (type < DeckCommand::numTypes && fields[4] != DeckCommand::getTypeName((DeckCommand::Type) type)) {
+            ++type;
+        }
+
+        const int channel = fields[1].getIntValue() - 1;
+        const int number = fields[2].getIntValue();
+        const int deck = fields[3].getIntValue() - 1;
+        if (kind == numKinds || type == DeckCommand::numTypes || channel < 0 || channel >= 16
+            || number < 0 || number >= 128 || deck < 0 || deck > 1) {
+            continue;
+        }
+        table[(kind * 16 + channel) * 128 + number] = packTarget(deck, (DeckCommand::Type) type, fields[5].getIntValue());
+    }
+}
+
+void MidiRouter::saveMappings() const
+{
+    // Writing to MidiMappings.txt
+    std::ofstream file("MidiMappings.txt");
+    for (int key = 0; key < tableSize; ++key) {
+        const int target = table[key].load();
+        if (target == 0) {
+            continue;
+        }
+
+        const DeckCommand command = unpackTarget(target);
+        file << kindNames[key / (16 * 128)] << "\t" << (key / 128) % 16 + 1 << "\t" << key % 128 << "\t"
+             << command.deck + 1 << "\t" << DeckCommand::getTypeName(command.type) << "\t" << (int) command.value << std::endl;
+    }
+}
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    MidiRouter.h
+    Created: 20 Oct 2026 6:20:03pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "DJAudioPlayer.h"
+#include "DeckCommand.h"
+
+//==============================================================================
+/*
+    Routes a MIDI controller straight to the decks on the audio thread.
+
+    Notes, controllers and pitch bends are looked up in a mapping table on
+    the MIDI thread and turned into DeckCommands, which are pushed through a
+    lock-free FIFO. At the start of every audio block the commands are taken
+    off the FIFO and handed to the decks with the sample they should land on,
+    worked out from when each message arrived, so the message thread is
+    never involved and a fader or jog moves at the same rate the hand did.
+
+    The mapping is learnt: startLearning picks a command, and the next note
+    or controller that arrives is mapped to it. Mappings are saved in
+    MidiMappings.txt.
+
+    The latency test sends a probe note out of a virtual "OtoDecks Latency
+    Probe" port every 100ms. When that port is connected to the virtual
+    "OtoDecks Controller" input, for example with aconnect on Linux, the time
+    from sending each probe to the sample it would be applied on is measured.
+*/
+class MidiRouter  : public MidiInputCallback,
+                    private AsyncUpdater,
+                    private Timer
+{
+public:
+    // Time from a message arriving, or a probe being sent, to the sample it lands on
+    struct LatencyStats
+    {
+        int messages = 0;
+        double averageMs = 0;
+        double worstMs = 0;
+        int probes = 0;
+        double probeAverageMs = 0;
+        double probeWorstMs = 0;
+    };
+
+    MidiRouter(AudioDeviceManager& deviceManagerToUse, DJAudioPlayer& deck1, DJAudioPlayer& deck2);
+    ~MidiRouter() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /** called at the start of every audio block, before the decks are rendered */
+    void processBlock(int numSamples);
+
+    /** map the next note or controller that arrives to a command, a hot cue's index is given as its value */
+    void startLearning(int deck, DeckCommand::Type type, int value = 0);
+    void cancelLearning();
+    bool isLearning(int deck) const;
+
+    /** remove the mapping of a command */
+    void clearMapping(int deck, DeckCommand::Type type, int value = 0);
+
+    /** get the control mapped to a command, such as "CC 7 ch 1", or an empty string */
+    String getMappingDescription(int deck, DeckCommand::Type type, int value = 0) const;
+
+    /** start or stop sending probes out of the virtual port */
+    void setLatencyTest(bool enabled);
+    bool isLatencyTestRunning() const;
+
+    /** get the latencies measured since the last call, called on the message thread */
+    LatencyStats getLatencyStats();
+
+    void handleIncomingMidiMessage(MidiInput* source, const MidiMessage& message) override;
+
+private:
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+
+    enum Kind { noteKind, controllerKind, pitchBendKind, numKinds };
+
+    // Function to get the table index of a message, or -1 when it cannot be mapped
+    static int getKey(const MidiMessage& message);
+
+    // Functions to pack a command into a table entry and back, 0 is no command
+    static int packTarget(int deck, DeckCommand::Type type, int value);
+    static DeckCommand unpackTarget(int target);
+
+    // Function to turn a message into the command it is mapped to, called on the MIDI thread
+    bool createCommand(const MidiMessage& message, int target, DeckCommand& command) const;
+
+    // Function to add a measured latency to the running totals, called on the audio thread
+    static void addLatency(double seconds, std::atomic<int>& count, std::atomic<double>& total, std::atomic<double>& worst);
+
+    void loadMappings();
+    void saveMappings() const;
+
+    static constexpr int tableSize = numKinds * 16 * 128;
+    static constexpr int fifoSize = 1024;
+
+    // The probe is a note on the last channel that is never mapped while the test runs
+    static constexpr int probeChannel = 16;
+    static constexpr int probeNote = 127;
+
+    AudioDeviceManager& deviceManager;
+    DJAudioPlayer* decks[2];
+
+    // Written by the message thread, read by the MIDI thread
+    std::atomic<int> table[tableSize];
+    std::atomic<int> learnTarget{ 0 };
+
+    // Written by the MIDI thread when a control arrives while learning
+    std::atomic<int> learntKey{ -1 };
+
+    // Commands from the MIDI thread to the audio thread, the lock only keeps two inputs from writing at once
+    AbstractFifo fifo{ fifoSize };
+    DeckCommand commands[fifoSize];
+    SpinLock writeLock;
+
+    std::unique_ptr<MidiInput> virtualInput;
+    std::unique_ptr<MidiOutput> probeOutput;
+    std::atomic<bool> latencyTest{ false };
+    std::atomic<double> probeSentAt{ 0 };
+
+    // Only touched by the audio thread, apart from the running totals
+    double sampleRate = 44100;
+    std::atomic<int> messageCount{ 0 };
+    std::atomic<double> messageTotal{ 0 };
+    std::atomic<double> messageWorst{ 0 };
+    std::atomic<int> probeCount{ 0 };
+    std::atomic<double> probeTotal{ 0 };
+    std::atomic<double> probeWorst{ 0 };
+
+    // Only touched by the message thread, the totals at the last getLatencyStats
+    int lastMessageCount = 0;
+    double lastMessageTotal = 0;
+    int lastProbeCount = 0;
+    double lastProbeTotal = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiRouter)
+};
@@ -0,0 +1,369 @@
+/*
+  ==============================================================================
+
+    Mp3SeekIndex.cpp
+    Created: 19 Oct 2026 10:03:15am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Mp3SeekIndex.h"
+#include "Tracer.h"
+
+//==============================================================================
+namespace
+{
+    // Details of one mp3 frame taken from its 4 byte header
+    struct FrameHeader
+    {
+        int length = 0;
+        int samples = 0;
+        int sampleRate = 0;
+    };
+
+    bool parseFrameHeader(const uint8* h, FrameHeader& header)
+    {
+        // Checking the 11 bit frame sync
+        if (h[0] != 0xff || (h[1] & 0xe0) != 0xe0) {
+            return false;
+        }
+
+        const int versionBits = (h[1] >> 3) & 3;   // 0 = MPEG 2.5, 2 = MPEG 2, 3 = MPEG 1
+        const int layerBits = (h[1] >> 1) & 3;     // 1 = layer III, 2 = layer II, 3 = layer I
+        const int bitrateIndex = h[2] >> 4;
+        const int sampleRateIndex = (h[2] >> 2) & 3;
+        const int padding = (h[2] >> 1) & 1;
+
+        // Free format bitrates have no fixed frame length so they cannot be indexed
+        if (versionBits == 1 || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3) {
+            return false;
+        }
+
+        static const int bitrates[2][3][15] = {
+            // MPEG 1: layer I, II, III
+            { { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+              { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+              { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 } },
+            // MPEG 2 and 2.5: layer I, II, III
+            { { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+              { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
+              { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } } };
+        static const int sampleRates[3] = { 44100, 48000, 32000 };
+
+        const bool mpeg1 = versionBits == 3;
+        const int layer = 4 - layerBits;
+        const int bitrate = bitrates[mpeg1 ? 0 : 1][layer - 1][bitrateIndex] * 1000;
+
+        // MPEG 2 halves the sample rate and MPEG 2.5 quarters it
+        header.sampleRate = sampleRates[sampleRateIndex] >> (mpeg1 ? 0 : (versionBits == 2 ? 1 : 2));
+
+        if (layer == 1) {
+            header.samples = 384;
+            header.length = (12 * bitrate / header.sampleRate + padding) * 4;
+        }
+        else {
+            header.samples = (layer == 3 && !mpeg1) ? 576 : 1152;
+            header.length = (header.samples / 8) * bitrate / header.sampleRate + padding;
+        }
+
+        return header.length > 4;
+    }
+
+    bool readFrameHeader(InputStream& input, int64 pos, FrameHeader& header)
+    {
+        uint8 h[4];
+        return input.setPosition(pos) && input.read(h, 4) == 4 && parseFrameHeader(h, header);
+    }
+
+    // Checks whether a frame is a Xing, Info or VBRI tag rather than audio
+    bool isVbrTagFrame(InputStream& input, int64 pos, int length)
+    {
+        HeapBlock<char> data((size_t) length);
+        if (!input.setPosition(pos) || input.read(data, length) != length) {
+            return false;
+        }
+
+        const int searchLength = jmin(length, 64);
+        for (int i = 4; i + 4 <= searchLength; ++i) {
+            if (memcmp(data + i, "Xing", 4) == 0 || memcmp(data + i, "Info", 4) == 0 || memcmp(data + i, "VBRI", 4) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const int indexFileMagic = (int) ByteOrder::littleEndianInt("OSIX");
+    const int indexFileVersion = 1;
+}
+
+//==============================================================================
+std::unique_ptr<Mp3SeekIndex> Mp3SeekIndex::loadOrBuild(const File& track)
+{
+    File cacheFile = getCacheFile(track);
+
+    // Using the saved index if it was built from the same version of the file
+    MemoryBlock data;
+    if (cacheFile.loadFileAsData(data)) {
+        MemoryInputStream input(data, false);
+        std::unique_ptr<Mp3SeekIndex> index(new Mp3SeekIndex());
+        if (index->loadFrom(input, track)) {
+            return index;
+        }
+    }
+
+    auto index = build(track);
+    if (index != nullptr && cacheFile.getParentDirectory().createDirectory()) {
+        // Writing to a temporary file first so that a reader never sees a half written index
+        TemporaryFile temp(cacheFile);
+        {
+            FileOutputStream output(temp.getFile());
+            if (output.openedOk()) {
+                index->writeTo(output);
+            }
+        }
+        temp.overwriteTargetFileWithTemporary();
+    }
+    return index;
+}
+
+std::unique_ptr<Mp3SeekIndex> Mp3SeekIndex::build(const File& track)
+{
+    TraceSpan span("Mp3SeekIndex::build");
+
+    FileInputStream fileStream(track);
+    if (!fileStream.openedOk()) {
+        return nullptr;
+    }
+
+    BufferedInputStream input(fileStream, 65536);
+    const int64 size = input.getTotalLength();
+    int64 pos = 0;
+
+    // Skipping the ID3v2 tag at the start of the file
+    uint8 id3[10];
+    if (input.read(id3, 10) == 10 && memcmp(id3, "ID3", 3) == 0) {
+        const int64 tagSize = ((id3[6] & 0x7f) << 21) | ((id3[7] & 0x7f) << 14) | ((id3[8] & 0x7f) << 7) | (id3[9] & 0x7f);
+        pos = 10 + tagSize + ((id3[5] & 0x10) != 0 ? 10 : 0);
+    }
+
+    std::unique_ptr<Mp3SeekIndex> index(new Mp3SeekIndex());
+    FrameHeader first;
+    bool synced = false;
+    int64 bytesSkipped = 0;
+
+    while (pos + 4 <= size)
+    {
+        FrameHeader header;
+        bool valid = readFrameHeader(input, pos, header) && pos + header.length <= size;
+
+        // Every frame must have the same format as the first one
+        if (valid && !index->frameOffsets.isEmpty()) {
+            valid = header.sampleRate == first.sampleRate && header.samples == first.samples;
+        }
+
+        // After a resync the next frame must also be valid, so random bytes are not taken as a frame
+        if (valid && !synced) {
+            FrameHeader next;
+            valid = pos + header.length == size
+                    || (readFrameHeader(input, pos + header.length, next) && next.sampleRate == header.sampleRate);
+        }
+
+        if (valid) {
+            if (index->frameOffsets.isEmpty() && !synced) {
+                first = header;
+
+                // The VBR tag frame decodes to silence and is not counted as audio
+                if (isVbrTagFrame(input, pos, header.length)) {
+                    synced = true;
+                    pos += header.length;
+                    continue;
+                }
+            }
+
+            index->frameOffsets.add(pos);
+            synced = true;
+            bytesSkipped = 0;
+            pos += header.length;
+            continue;
+        }
+
+        // Stopping at the ID3v1 or APE tag at the end of the file
+        uint8 tag[4];
+        if (input.setPosition(pos) && input.read(tag, 4) == 4
+            && (memcmp(tag, "TAG", 3) == 0 || memcmp(tag, "APET", 4) == 0)) {
+            break;
+        }
+
+        // Searching byte by byte for the next frame, giving up on files that are not mp3s
+        synced = false;
+        ++pos;
+        if (++bytesSkipped > 65536) {
+            break;
+        }
+    }
+
+    if (index->frameOffsets.isEmpty()) {
+        return nullptr;
+    }
+
+    index->fileSize = track.getSize();
+    index->modificationTime = track.getLastModificationTime().toMilliseconds();
+    index->samplesPerFrame = first.samples;
+    index->sampleRate = first.sampleRate;
+    index->endOffset = index->frameOffsets.getLast() + first.length;
+
+    // The last frame may be padded, so its end is found from its own header
+    FrameHeader last;
+    if (readFrameHeader(input, index->frameOffsets.getLast(), last)) {
+        index->endOffset = index->frameOffsets.getLast() + last.length;
+    }
+
+    return index;
+}
+
+bool Mp3SeekIndex::isUpToDate(const File& track) const
+{
+    return fileSize == track.getSize() && modificationTime == track.getLastModificationTime().toMilliseconds();
+}
+
+bool Mp3SeekIndex::loadFrom(InputStream& input, const File& track)
+{
+    if (input.readInt() != indexFileMagic || input.readInt() != indexFileVersion) {
+        return false;
+    }
+
+    // The index is out of date if the file has changed since it was built
+    fileSize = input.readInt64();
+    modificationTime = input.readInt64();
+    if (fileSize != track.getSize() || modificationTime != track.getLastModificationTime().toMilliseconds()) {
+        return false;
+    }
+
+    samplesPerFrame = input.readInt();
+    sampleRate = input.readDouble();
+    const int numFrames = input.readInt();
+    if (samplesPerFrame <= 0 || sampleRate <= 0 || numFrames <= 0
+        || input.getNumBytesRemaining() != 8 + 2 * (int64) numFrames) {
+        return false;
+    }
+
+    // The offsets are stored as the first offset followed by the length of every frame
+    int64 offset = input.readInt64();
+    frameOffsets.ensureStorageAllocated(numFrames);
+    for (int i = 0; i < numFrames; ++i) {
+        frameOffsets.add(offset);
+        offset += (uint16) input.readShort();
+    }
+    endOffset = offset;
+
+    return true;
+}
+
+void Mp3SeekIndex::writeTo(OutputStream& output) const
+{
+    output.writeInt(indexFileMagic);
+    output.writeInt(indexFileVersion);
+    output.writeInt64(fileSize);
+    output.writeInt64(modificationTime);
+    output.writeInt(samplesPerFrame);
+    output.writeDouble(sampleRate);
+    output.writeInt(frameOffsets.size());
+    output.writeInt64(frameOffsets.getFirst());
+
+    for (int i = 0; i < frameOffsets.size(); ++i) {
+        const int64 next = i + 1 < frameOffsets.size() ? frameOffsets[i + 1] : endOffset;
+        output.writeShort((short) (uint16) (next - frameOffsets[i]));
+    }
+}
+
+File Mp3SeekIndex::getCacheFile(const File& track)
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+               .getChildFile("OtoDecks")
+               .getChildFile("SeekIndex")
+               .getChildFile(String::toHexString(track.getFullPathName().hashCode64()) + ".idx");
+}
+
+//==============================================================================
+AudioFormatReader* IndexedMp3Reader::createReaderFor(AudioFormatManager& formatManager, const File& track,
+                                                     std::shared_ptr<const Mp3SeekIndex> seekIndex)
+{
+    auto* format = formatManager.findFormatForFileExtension(track.getFileExtension());
+
+    if (format != nullptr && track.hasFileExtension("mp3")) {
+        // The decoder seeks in steps of 1152 samples, so only files with that frame size use the index
+        if (seekIndex != nullptr && seekIndex->getSamplesPerFrame() == 1152) {
+            std::unique_ptr<IndexedMp3Reader> reader(new IndexedMp3Reader(*format, track, std::move(seekIndex)));
+            if (reader->frameReader != nullptr) {
+                return reader.release();
+            }
+        }
+    }
+
+    return formatManager.createReaderFor(track);
+}
+
+IndexedMp3Reader::IndexedMp3Reader(AudioFormat& formatToUse,
+                                   const File& track,
+                                   std::shared_ptr<const Mp3SeekIndex> seekIndex)
+                                   : AudioFormatReader(nullptr, formatToUse.getFormatName()),
+                                     format(formatToUse),
+                                     file(track),
+                                     index(std::move(seekIndex))
+{
+    frameReader = openAtFrame(0);
+
+    if (frameReader != nullptr) {
+        sampleRate = index->getSampleRate();
+        bitsPerSample = frameReader->bitsPerSample;
+        usesFloatingPointData = frameReader->usesFloatingPointData;
+        numChannels = frameReader->numChannels;
+        metadataValues = frameReader->metadataValues;
+
+        // Using the exact length from the index instead of the decoder's estimate
+        lengthInSamples = index->getTotalSamples();
+    }
+}
+
+bool IndexedMp3Reader::readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                                   int64 startSampleInFile, int numSamples)
+{
+    if (startSampleInFile != nextSample || frameReader == nullptr) {
+        // Looking up the frame holding the wanted sample and opening a decoder just before it
+        const int frame = (int) jlimit((int64) 0, (int64) index->getNumFrames() - 1,
+                                       startSampleInFile / index->getSamplesPerFrame());
+        const int startFrame = jmax(0, frame - warmUpFrames);
+
+        frameReader = openAtFrame(startFrame);
+        frameReaderStart = (int64) startFrame * index->getSamplesPerFrame();
+
+        if (frameReader == nullptr) {
+            for (int i = 0; i < numDestChannels; ++i) {
+                if (destChannels[i] != nullptr) {
+                    zeromem(destChannels[i] + startOffsetInDestBuffer, sizeof(int) * (size_t) numSamples);
+                }
+            }
+            return false;
+        }
+    }
+
+    nextSample = startSampleInFile + numSamples;
+    return frameReader->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                    startSampleInFile - frameReaderStart, numSamples);
+}
+
+std::unique_ptr<AudioFormatReader> IndexedMp3Reader::openAtFrame(int frame)
+{
+    auto fileStream = std::make_unique<FileInputStream>(file);
+    if (!fileStream->openedOk()) {
+        return nullptr;
+    }
+
+    // The decoder only sees the frames from the wanted one to the end of the audio
+    const int64 start = index->getFrameOffset(frame);
+    auto* region = new SubregionStream(fileStream.release(), start, index->getEndOffset() - start, true);
+
+    return std::unique_ptr<AudioFormatReader>(format.createReaderFor(new BufferedInputStream(region, 16384, true), true));
+}
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    Mp3SeekIndex.h
+    Created: 19 Oct 2026 10:03:15am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Table of the byte offset of every frame in an mp3 file.
+
+    The table is built by walking the frame headers once, without decoding
+    anything, and is saved in the application data folder so it only has to
+    be built the first time a track is opened. With it, the exact length of a
+    VBR file is known and any sample can be found with a table lookup.
+*/
+class Mp3SeekIndex
+{
+public:
+    /** get the index of a track from the cache, building and saving it when it is missing or out of date */
+    static std::unique_ptr<Mp3SeekIndex> loadOrBuild(const File& track);
+
+    /** walk the frame headers of a track, returns nullptr if it is not an mp3 that can be indexed */
+    static std::unique_ptr<Mp3SeekIndex> build(const File& track);
+
+    int getNumFrames() const                 { return frameOffsets.size(); }
+    int getSamplesPerFrame() const           { return samplesPerFrame; }
+    double getSampleRate() const             { return sampleRate; }
+    int64 getTotalSamples() const            { return (int64) getNumFrames() * samplesPerFrame; }
+
+    /** get the byte offset of the start of a frame */
+    int64 getFrameOffset(int frame) const    { return frameOffsets[frame]; }
+
+    /** get the byte offset just after the last frame */
+    int64 getEndOffset() const               { return endOffset; }
+
+    /** true if the index was built from the track as it is on disk now */
+    bool isUpToDate(const File& track) const;
+
+private:
+    Mp3SeekIndex() = default;
+
+    bool loadFrom(InputStream& input, const File& track);
+    void writeTo(OutputStream& output) const;
+
+    static File getCacheFile(const File& track);
+
+    int64 fileSize = 0;
+    int64 modificationTime = 0;
+    int samplesPerFrame = 0;
+    double sampleRate = 0;
+    Array<int64> frameOffsets;
+    int64 endOffset = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Mp3SeekIndex)
+};
+
+//==============================================================================
+/*
+    Reader that seeks an mp3 file using its Mp3SeekIndex.
+
+    Reading carries on from the same decoder until a seek happens. A seek
+    looks up the frame holding the wanted sample and opens a fresh decoder a
+    couple of frames before it, so the bit reservoir is filled before the
+    wanted frame is decoded. The length reported is the exact one from the
+    index rather than the estimate the decoder makes for VBR files.
+*/
+class IndexedMp3Reader  : public AudioFormatReader
+{
+public:
+    /** open a reader for a track, seeking with the given index when there is one that can be used. The index is
+        shared, so every reader of the same track uses one copy of it */
+    static AudioFormatReader* createReaderFor(AudioFormatManager& formatManager, const File& track,
+                                              std::shared_ptr<const Mp3SeekIndex> seekIndex);
+
+    IndexedMp3Reader(AudioFormat& formatToUse,
+                     const File& track,
+                     std::shared_ptr<const Mp3SeekIndex> seekIndex);
+
+    bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                     int64 startSampleInFile, int numSamples) override;
+
+private:
+    // Function to open a decoder starting at the given frame
+    std::unique_ptr<AudioFormatReader> openAtFrame(int frame);
+
+    // Frames decoded before the wanted one after a seek
+    static constexpr int warmUpFrames = 2;
+
+    AudioFormat& format;
+    File file;
+    std::shared_ptr<const Mp3SeekIndex> index;
+
+    std::unique_ptr<AudioFormatReader> frameReader;
+    int64 frameReaderStart = 0;
+    int64 nextSample = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IndexedMp3Reader)
+};
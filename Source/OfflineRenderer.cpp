@@ -0,0 +1,369 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 19 Oct 2026 9:37:26pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+#include "DJAudioPlayer.h"
+
+//==============================================================================
+namespace
+{
+    // Function to open a writer for a file, as FLAC if it ends in .flac and as WAV otherwise
+    std::unique_ptr<AudioFormatWriter> createWriterFor(const File& file, double sampleRate, int bitsPerSample)
+    {
+        file.deleteFile();
+        std::unique_ptr<FileOutputStream> stream(file.createOutputStream());
+        if (stream == nullptr) {
+            return nullptr;
+        }
+
+        WavAudioFormat wav;
+        FlacAudioFormat flac;
+        AudioFormat& format = file.hasFileExtension(".flac") ? (AudioFormat&) flac : (AudioFormat&) wav;
+
+        std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate, 2, bitsPerSample, {}, 0));
+        if (writer != nullptr) {
+            stream.release();
+        }
+        return writer;
+    }
+}
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer(AudioFormatManager& formatManagerToUse)
+                                 : formatManager(formatManagerToUse)
+{
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+}
+
+Result OfflineRenderer::loadTimeline(const File& timelineFile)
+{
+    var timeline;
+    Result parsed = JSON::parse(timelineFile.loadFileAsString(), timeline);
+    if (parsed.failed()) {
+        return Result::fail("Could not read " + timelineFile.getFileName() + ": " + parsed.getErrorMessage());
+    }
+
+    sampleRate = timeline.getProperty("sampleRate", 44100.0);
+    blockSize = timeline.getProperty("blockSize", 512);
+    lengthInSeconds = timeline.getProperty("length", 0.0);
+    numDecks = timeline.getProperty("decks", 2);
+    actions.clear();
+    trackLengths.clear();
+
+    if (sampleRate <= 0 || blockSize <= 0 || lengthInSeconds <= 0 || numDecks <= 0) {
+        return Result::fail("The sample rate, block size, length and number of decks should be above 0");
+    }
+
+    auto* list = timeline["actions"].getArray();
+    if (list == nullptr) {
+        return Result::fail("The timeline has no list of actions");
+    }
+
+    const StringArray deckActions{ "load", "play", "stop", "seek", "speed", "gain" };
+
+    for (auto& item : *list)
+    {
+        Action action;
+        action.time = item.getProperty("time", 0.0);
+        action.type = item["action"].toString();
+
+        if (action.type == "crossfade") {
+            action.deck = item.getProperty("from", 0);
+            action.toDeck = item.getProperty("to", 0);
+            action.duration = item.getProperty("duration", 0.0);
+            if (!isPositiveAndNotGreaterThan(action.toDeck, numDecks) || action.toDeck == 0) {
+                return Result::fail("A crossfade at " + String(action.time) + "s goes to a deck that does not exist");
+            }
+        }
+        else if (deckActions.contains(action.type)) {
+            action.deck = item.getProperty("deck", 0);
+            action.value = item.getProperty("value", 0.0);
+        }
+        else {
+            return Result::fail("Unknown action \"" + action.type + "\" at " + String(action.time) + "s");
+        }
+
+        if (!isPositiveAndNotGreaterThan(action.deck, numDecks) || action.deck == 0) {
+            return Result::fail("The " + action.type + " at " + String(action.time) + "s is on a deck that does not exist");
+        }
+
+        if (action.type == "load") {
+            action.file = timelineFile.getParentDirectory().getChildFile(item["file"].toString());
+
+            // The length of each track is needed to know when it stops by itself
+            std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(action.file));
+            if (reader == nullptr) {
+                return Result::fail("Could not open " + action.file.getFullPathName());
+            }
+            trackLengths.set(action.file.getFullPathName(), reader->lengthInSamples / reader->sampleRate);
+        }
+
+        actions.add(action);
+    }
+
+    // Actions at the same time are kept in the order they were written
+    std::stable_sort(actions.begin(), actions.end(), [](const Action& a, const Action& b) { return a.time < b.time; });
+    return Result::ok();
+}
+
+Result OfflineRenderer::render(const File& outputFile, int numThreads, double segmentSeconds)
+{
+    if (lengthInSeconds <= 0) {
+        return Result::fail("No timeline has been loaded");
+    }
+
+    const double startMs = Time::getMillisecondCounterHiRes();
+    const int64 totalSamples = (int64) std::llround(lengthInSeconds * sampleRate);
+
+    auto writer = createWriterFor(outputFile, sampleRate, 24);
+    if (writer == nullptr) {
+        return Result::fail("Could not write " + outputFile.getFullPathName());
+    }
+
+    const int64 segmentSamples = jmax((int64) blockSize, (int64) std::llround(segmentSeconds * sampleRate));
+
+    if (numThreads <= 1 || totalSamples <= segmentSamples) {
+        if (!renderRange(0, totalSamples, *writer)) {
+            return Result::fail("Could not write " + outputFile.getFullPathName());
+        }
+    }
+    else {
+        // Each segment is rendered into its own float file, and they are joined in order at the end
+        OwnedArray<TemporaryFile> segmentFiles;
+        std::atomic<bool> failed{ false };
+        ThreadPool pool(numThreads);
+
+        for (int64 start = 0; start < totalSamples; start += segmentSamples) {
+            const int64 end = jmin(totalSamples, start + segmentSamples);
+            auto* segmentFile = segmentFiles.add(new TemporaryFile(".wav"));
+
+            pool.addJob([this, start, end, segmentFile, &failed] {
+                auto segmentWriter = createWriterFor(segmentFile->getFile(), sampleRate, 32);
+                if (segmentWriter == nullptr || !renderRange(start, end, *segmentWriter)) {
+                    failed = true;
+                }
+            });
+        }
+
+        while (pool.getNumJobs() > 0) {
+            Thread::sleep(5);
+        }
+
+        if (failed) {
+            return Result::fail("Could not render every segment");
+        }
+
+        WavAudioFormat wav;
+        for (auto* segmentFile : segmentFiles) {
+            std::unique_ptr<AudioFormatReader> reader(wav.createReaderFor(new FileInputStream(segmentFile->getFile()), true));
+            if (reader == nullptr || !writer->writeFromAudioReader(*reader, 0, -1)) {
+                return Result::fail("Could not join the segments into " + outputFile.getFullPathName());
+            }
+        }
+    }
+
+    writer.reset();
+
+    const double elapsedSeconds = (Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    speedUp = elapsedSeconds > 0 ? lengthInSeconds / elapsedSeconds : 0.0;
+    return Result::ok();
+}
+
+double OfflineRenderer::getSpeedUp() const
+{
+    return speedUp;
+}
+
+OfflineRenderer::DeckState OfflineRenderer::getDeckStateAt(int deck, double time) const
+{
+    DeckState state;
+    double lastTime = 0;
+
+    // Function to move the playhead on, stopping at the end of the track like the transport does
+    auto advance = [this, &state](double seconds) {
+        if (state.playing) {
+            const double length = trackLengths[state.file.getFullPathName()];
+            state.position += state.speed * seconds;
+            if (state.position >= length) {
+                state.position = length;
+                state.playing = false;
+            }
+        }
+    };
+
+    for (auto& action : actions)
+    {
+        if (action.time >= time) {
+            break;
+        }
+
+        advance(action.time - lastTime);
+        lastTime = action.time;
+
+        if (action.deck != deck) {
+            continue;
+        }
+
+        if (action.type == "load") {
+            state.file = action.file;
+            state.position = 0;
+            state.playing = false;
+        }
+        else if (action.type == "play") {
+            state.playing = state.file != File();
+        }
+        else if (action.type == "stop") {
+            state.playing = false;
+        }
+        else if (action.type == "seek") {
+            state.position = action.value;
+        }
+        else if (action.type == "speed") {
+            state.speed = action.value;
+        }
+        else if (action.type == "gain") {
+            state.gain = action.value;
+        }
+    }
+
+    advance(time - lastTime);
+    return state;
+}
+
+float OfflineRenderer::getMixGainAt(int deck, double time) const
+{
+    // The latest crossfade a deck is part of decides its gain, with the same equal power curve as the auto DJ
+    float gain = 1.0f;
+    for (auto& action : actions)
+    {
+        if (action.time > time) {
+            break;
+        }
+        if (action.type != "crossfade") {
+            continue;
+        }
+
+        const double x = action.duration > 0 ? jlimit(0.0, 1.0, (time - action.time) / action.duration) : 1.0;
+        if (deck == action.deck) {
+            gain = (float) std::cos(x * MathConstants<double>::halfPi);
+        }
+        if (deck == action.toDeck) {
+            gain = (float) std::sin(x * MathConstants<double>::halfPi);
+        }
+    }
+    return gain;
+}
+
+bool OfflineRenderer::renderRange(int64 startSample, int64 endSample, AudioFormatWriter& writer) const
+{
+    auto sampleOf = [this](const Action& action) { return (int64) std::llround(action.time * sampleRate); };
+
+    // Segments after the first start a little early, and the extra audio is not written
+    const int64 renderStart = jmax((int64) 0, startSample - (int64) (preRollSeconds * sampleRate));
+
+    // The same graph as MainComponent, decoding on the render call instead of a read-ahead thread
+    OwnedArray<DJAudioPlayer> decks;
+    MixerAudioSource mixer;
+    for (int i = 0; i < numDecks; ++i) {
+        mixer.addInputSource(decks.add(new DJAudioPlayer(formatManager, false)), false);
+    }
+    mixer.prepareToPlay(blockSize, sampleRate);
+
+    // Putting each deck in the state the actions before this range leave it in
+    int next = 0;
+    while (next < actions.size() && sampleOf(actions.getReference(next)) < renderStart) {
+        ++next;
+    }
+    const double renderStartTime = next < actions.size() ? jmin(renderStart / sampleRate, actions.getReference(next).time)
+                                                         : renderStart / sampleRate;
+
+    for (int i = 0; i < numDecks; ++i) {
+        DeckState state = getDeckStateAt(i + 1, renderStartTime);
+        auto* deck = decks[i];
+        if (state.file != File()) {
+            deck->loadURL(URL{ state.file });
+            deck->setPosition(state.position);
+        }
+        deck->setSpeed(state.speed);
+        deck->setGain(state.gain);
+        deck->setMixGain(getMixGainAt(i + 1, renderStart / sampleRate));
+        if (state.playing) {
+            deck->start();
+        }
+    }
+
+    auto apply = [&decks](const Action& action) {
+        auto* deck = decks[action.deck - 1];
+        if (action.type == "load") {
+            deck->loadURL(URL{ action.file });
+        }
+        else if (action.type == "play") {
+            deck->start();
+        }
+        else if (action.type == "stop") {
+            deck->stop();
+        }
+        else if (action.type == "seek") {
+            deck->setPosition(action.value);
+        }
+        else if (action.type == "speed") {
+            deck->setSpeed(action.value);
+        }
+        else if (action.type == "gain") {
+            deck->setGain(action.value);
+        }
+    };
+
+    AudioBuffer<float> buffer(2, blockSize);
+    bool ok = true;
+
+    for (int64 pos = renderStart; pos < endSample && ok;)
+    {
+        const int numSamples = (int) jmin((int64) blockSize, endSample - pos);
+        int offset = 0;
+
+        // The block is split wherever an action falls, so every action lands on its exact sample
+        while (offset < numSamples)
+        {
+            while (next < actions.size() && sampleOf(actions.getReference(next)) <= pos + offset) {
+                apply(actions.getReference(next++));
+            }
+
+            int chunk = numSamples - offset;
+            if (next < actions.size()) {
+                chunk = (int) jmin((int64) chunk, sampleOf(actions.getReference(next)) - (pos + offset));
+            }
+
+            // The crossfade gains ramp to where they should be at the end of the chunk
+            for (int i = 0; i < numDecks; ++i) {
+                decks[i]->setMixGain(getMixGainAt(i + 1, (pos + offset + chunk) / sampleRate));
+            }
+
+            mixer.getNextAudioBlock(AudioSourceChannelInfo(&buffer, offset, chunk));
+            offset += chunk;
+        }
+
+        if (pos + numSamples > startSample) {
+            const int skip = (int) jmax((int64) 0, startSample - pos);
+            ok = writer.writeFromAudioSampleBuffer(buffer, skip, numSamples - skip);
+        }
+        pos += numSamples;
+    }
+
+    mixer.removeAllInputs();
+    for (auto* deck : decks) {
+        deck->releaseResources();
+    }
+    return ok;
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 19 Oct 2026 9:37:26pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Renders a mix from a timeline of deck actions without an audio device.
+
+    The timeline is a JSON file such as
+
+        {
+          "sampleRate": 44100, "blockSize": 512, "length": 300, "decks": 2,
+          "actions": [
+            { "time": 0,   "deck": 1, "action": "load", "file": "intro.mp3" },
+            { "time": 0,   "deck": 1, "action": "play" },
+            { "time": 90,  "deck": 2, "action": "load", "file": "next.mp3" },
+            { "time": 90,  "deck": 2, "action": "seek", "value": 12.5 },
+            { "time": 90,  "deck": 2, "action": "play" },
+            { "time": 90,  "action": "crossfade", "from": 1, "to": 2, "duration": 8 },
+            { "time": 120, "deck": 2, "action": "speed", "value": 1.04 },
+            { "time": 200, "deck": 2, "action": "gain", "value": 0.8 },
+            { "time": 290, "deck": 2, "action": "stop" }
+          ]
+        }
+
+    where times are in seconds and files are relative to the timeline. The
+    decks are DJAudioPlayers mixed by a MixerAudioSource, as in MainComponent,
+    and actions are applied on the exact sample they fall on. The mix is
+    rendered as fast as the decoders allow. It can also be split into
+    segments that render in parallel, each one starting from the state the
+    decks would be in at that point, with a short pre-roll to settle the
+    resamplers.
+*/
+class OfflineRenderer
+{
+public:
+    OfflineRenderer(AudioFormatManager& formatManagerToUse);
+    ~OfflineRenderer();
+
+    /** read a timeline, failing with a message when it cannot be used */
+    Result loadTimeline(const File& timelineFile);
+
+    /** render the loaded timeline to a WAV or FLAC file, with segments shared between the given number of threads */
+    Result render(const File& outputFile, int numThreads = 1, double segmentSeconds = 60.0);
+
+    /** get how many times faster than real time the last render was */
+    double getSpeedUp() const;
+
+private:
+    struct Action
+    {
+        double time = 0;
+        int deck = 0;
+        String type;
+        File file;
+        double value = 0;
+        int toDeck = 0;
+        double duration = 0;
+    };
+
+    // What a deck is doing at some point in the timeline
+    struct DeckState
+    {
+        File file;
+        bool playing = false;
+        double position = 0;
+        double speed = 1.0;
+        double gain = 1.0;
+    };
+
+    // Function to work out a deck's state just before a time, without rendering anything
+    DeckState getDeckStateAt(int deck, double time) const;
+
+    // Function to get the crossfade gain of a deck at a time
+    float getMixGainAt(int deck, double time) const;
+
+    // Function to render part of the timeline into a writer
+    bool renderRange(int64 startSample, int64 endSample, AudioFormatWriter& writer) const;
+
+    // Seconds rendered and thrown away before a segment, so the resamplers have settled at its start
+    static constexpr double preRollSeconds = 0.5;
+
+    AudioFormatManager& formatManager;
+
+    double sampleRate = 44100.0;
+    int blockSize = 512;
+    double lengthInSeconds = 0;
+    int numDecks = 2;
+    Array<Action> actions;
+    HashMap<String, double> trackLengths;
+
+    double speedUp = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineRenderer)
+};
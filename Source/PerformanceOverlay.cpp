@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    PerformanceOverlay.cpp
+    Created: 19 Oct 2026 5:40:52pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PerformanceOverlay.h"
+
+//==============================================================================
+PerformanceOverlay::PerformanceOverlay(AudioCallbackMonitor& monitorToShow)
+                                       : monitor(monitorToShow)
+{
+    // The overlay only shows text, so clicks go through to the decks underneath
+    setInterceptsMouseClicks(false, false);
+}
+
+PerformanceOverlay::~PerformanceOverlay()
+{
+    stopTimer();
+}
+
+void PerformanceOverlay::paint (juce::Graphics& g)
+{
+    g.fillAll(Colours::black.withAlpha(0.8f));
+
+    g.setColour(Colours::orange);
+    g.drawRect(getLocalBounds(), 1);
+
+    g.setColour(Colours::white);
+    g.setFont(Font(Font::getDefaultMonospacedFontName(), 12.0f, Font::plain));
+    g.drawMultiLineText(report, 8, 18, getWidth() - 16);
+}
+
+void PerformanceOverlay::visibilityChanged()
+{
+    // Only refreshing the report while it can be seen
+    if (isVisible()) {
+        timerCallback();
+        startTimer(250);
+    }
+    else {
+        stopTimer();
+    }
+}
+
+void PerformanceOverlay::timerCallback()
+{
+    report = monitor.getReport();
+    repaint();
+}
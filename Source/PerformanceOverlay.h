@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    PerformanceOverlay.h
+    Created: 19 Oct 2026 5:40:52pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioCallbackMonitor.h"
+
+//==============================================================================
+/*
+    Shows the audio callback timing report on top of the decks.
+*/
+class PerformanceOverlay  : public juce::Component,
+                            private Timer
+{
+public:
+    PerformanceOverlay(AudioCallbackMonitor& monitorToShow);
+    ~PerformanceOverlay() override;
+
+    void paint (juce::Graphics&) override;
+
+    void visibilityChanged() override;
+
+private:
+    void timerCallback() override;
+
+    AudioCallbackMonitor& monitor;
+    String report;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceOverlay)
+};
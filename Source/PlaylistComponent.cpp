@@ -11,15 +11,21 @@
 #include <JuceHeader.h>
 #include "PlaylistComponent.h"
 #include "MainComponent.h"
+#include "KeyDetector.h"
+#include "PlaylistExporter.h"
+#include "Tracer.h"
+
+#include <unordered_set>
 
 //==============================================================================
 PlaylistComponent::PlaylistComponent()
 {
-    formatManager.registerBasicFormats();
+    TraceSpan span("PlaylistComponent::PlaylistComponent");
 
     // Creating the table component with the respective headers
     tableComponent.getHeader().addColumn("Track Title", 1, 200);
     tableComponent.getHeader().addColumn("Track Length", 2, 200);
+    tableComponent.getHeader().addColumn("Key", 6, 100);
     tableComponent.getHeader().addColumn("Deck 1", 3, 100);
     tableComponent.getHeader().addColumn("Deck 2", 4, 100);
     tableComponent.getHeader().addColumn("Delete", 5, 200);
@@ -29,13 +35,30 @@ PlaylistComponent::PlaylistComponent()
 
     addAndMakeVisible(tableComponent);
     addAndMakeVisible(loadButton);
+    addAndMakeVisible(autoDJButton);
+    addAndMakeVisible(settingsButton);
+    addAndMakeVisible(recordButton);
+    addAndMakeVisible(foldersButton);
+    addAndMakeVisible(playlistButton);
+    addAndMakeVisible(keyButton);
     addAndMakeVisible(findFile);
 
     loadButton.addListener(this);
+    autoDJButton.onClick = [this] { toggleAutoDJ(); };
+    recordButton.onClick = [this] { toggleRecording(); };
+    foldersButton.onClick = [this] { showWatchedFolders(); };
+    playlistButton.onClick = [this] { showPlaylistMenu(); };
+    keyButton.onClick = [this] { showKeyMenu(); };
+    settingsButton.onClick = [this] {
+        if (mainComponent != nullptr) {
+            mainComponent->showAudioSettings();
+        }
+    };
     findFile.addListener(this);
 
     // reading from the playlist.txt file to ensure that the tracks added before the
-    // application was closed still persists and appears in the application
+    // application was closed still persists and appears in the application.
+    // Only the file is read here, no track is opened before the window appears
     std::ifstream playlist("Playlist.txt");
     std::string string;
     if (is_empty(playlist)) {
@@ -44,20 +67,18 @@ PlaylistComponent::PlaylistComponent()
     }
     else {
         while (std::getline(playlist, string)) {
-            // Adding the path to track playlist
-            trackPlaylist.add(string);
-
-            String file_path = string;
-            // Converting the string to a JUCE File
-            juce::File file(file_path);
-
-            if (!file.existsAsFile()) {
-                DBG("File does not exists");
+            String line = string;
+
+            // Lines are "length <tab> path", older files only have the path and the length is found later
+            const String lengthText = line.upToFirstOccurrenceOf("\t", false, false);
+            const bool hasLength = line.containsChar('\t') && lengthText.isNotEmpty() && lengthText.containsOnly("0123456789.");
+            const String file_path = hasLength ? line.fromFirstOccurrenceOf("\t", false, false) : line;
+            if (file_path.isEmpty() || trackPlaylist.contains(file_path)) {
+                continue;
             }
 
-            // Adding the track title and track length
-            trackTitles.add(title(file));
-            trackLength.add(duration(file));
+            // Adding the path with the track length, the title is read from the path
+            addTrack(file_path, hasLength ? lengthText.getDoubleValue() : -1.0);
         }
         playlist.close();
     }
@@ -65,6 +86,9 @@ PlaylistComponent::PlaylistComponent()
 
 PlaylistComponent::~PlaylistComponent()
 {
+    // The jobs check the flag between tracks, so the running one finishes quickly
+    stopping = true;
+    lengthPool.removeAllJobs(true, 10000);
 }
 
 void PlaylistComponent::paint (juce::Graphics& g)
@@ -89,8 +113,14 @@ void PlaylistComponent::paint (juce::Graphics& g)
 void PlaylistComponent::resized()
 {
     double rowH = getHeight() / 8;
-    loadButton.setBounds(0, 0, getWidth() / 2, rowH);
-    findFile.setBounds(getWidth() / 2, 0, getWidth() / 2, rowH);
+    loadButton.setBounds(0, 0, getWidth() / 8, rowH);
+    foldersButton.setBounds(getWidth() / 8, 0, getWidth() / 8, rowH);
+    playlistButton.setBounds(getWidth() * 2 / 8, 0, getWidth() / 8, rowH);
+    keyButton.setBounds(getWidth() * 3 / 8, 0, getWidth() / 8, rowH);
+    autoDJButton.setBounds(getWidth() * 4 / 8, 0, getWidth() / 8, rowH);
+    recordButton.setBounds(getWidth() * 5 / 8, 0, getWidth() / 8, rowH);
+    settingsButton.setBounds(getWidth() * 6 / 8, 0, getWidth() / 8, rowH);
+    findFile.setBounds(getWidth() * 7 / 8, 0, getWidth() - getWidth() * 7 / 8, rowH);
     tableComponent.setBounds(0, rowH, getWidth(), rowH * 7);
 
     findFile.setTextToShowWhenEmpty("Search.....", Colours::white);
@@ -99,7 +129,7 @@ void PlaylistComponent::resized()
 
 int PlaylistComponent::getNumRows()
 {
-    return trackTitles.size();
+    return compatibleDeck == 0 ? trackPlaylist.size() : visibleRows.size();
 }
 
 void PlaylistComponent::paintRowBackground(Graphics& g, int rowNumber, int width, int height, bool rowIsSelected)
@@ -116,14 +146,24 @@ void PlaylistComponent::paintRowBackground(Graphics& g, int rowNumber, int width
 
 void PlaylistComponent::paintCell(Graphics& g, int rowNumber, int columnId, int width, int height, bool rowIsSelected)
 {
+    const int track = getTrackIndex(rowNumber);
     if (columnId == 1) {
         g.setColour(juce::Colours::white);
-        g.drawText(trackTitles[rowNumber], 2, 0, width - 4, height, Justification::centredLeft, true);
+        g.drawText(trackPlaylist.getTitle(track), 2, 0, width - 4, height, Justification::centredLeft, true);
 
     }
     if (columnId == 2) {
+        // The length is left blank until a track that was not saved with one has been opened
+        g.setColour(Colours::white);
+        g.drawText(trackLength[track] >= 0 ? convert(trackLength[track]) : String(),
+                   2, 0, width - 4, height, Justification::centredLeft, true);
+    }
+    if (columnId == 6) {
+        // Showing the key on the Camelot wheel next to its name, such as "8A Am"
+        const int key = trackKeys[track];
         g.setColour(Colours::white);
-        g.drawText(convert(trackLength[rowNumber]), 2, 0, width - 4, height, Justification::centredLeft, true);
+        g.drawText(key >= 0 ? KeyDetector::getCamelotName(key) + " " + KeyDetector::getKeyName(key) : String(),
+                   2, 0, width - 4, height, Justification::centredLeft, true);
     }
 }
 
@@ -168,35 +208,51 @@ Component* PlaylistComponent::refreshComponentForCell(int rowNumber, int columnI
     return existingComponentToUpdate;
 }
 
+void PlaylistComponent::selectedRowsChanged(int lastRowSelected)
+{
+    if (mainComponent == nullptr || lastRowSelected < 0) {
+        return;
+    }
+
+    // Warming up the selected track and the next one in the list so adding them to a deck is instant
+    Array<File> tracks;
+    tracks.add(File(trackPlaylist.getPath(getTrackIndex(lastRowSelected))));
+    if (lastRowSelected + 1 < getNumRows()) {
+        tracks.add(File(trackPlaylist.getPath(getTrackIndex(lastRowSelected + 1))));
+    }
+    mainComponent->preloadTracks(tracks);
+}
+
 void PlaylistComponent::buttonClicked(Button* button)
 {
     if (button == &loadButton) {
         auto fileChooserFlags = FileBrowserComponent::canSelectMultipleItems;
 
         fChooser.launchAsync(fileChooserFlags, [this](const FileChooser& chooser) {
+            TraceSpan span("PlaylistComponent import");
+
             // Getting the file chosen by the user and adding it to an array of files
             Array<File> fileChosen = chooser.getResults();
 
         // looping the array
+        const int firstNewTrack = trackPlaylist.size();
         for (int i = 0; i < fileChosen.size(); i++) {
             String trackPath = fileChosen[i].getFullPathName().toStdString();
-            String name = title(fileChosen[i]);
             double length = duration(fileChosen[i]);
 
             // checking if there are duplicates
-            if (trackPlaylist.indexOf(trackPath) != -1) {
+            if (trackPlaylist.contains(trackPath)) {
                 DBG("File is already in playlist");
             }
             else {
                 // updating the various arrays
-                trackPlaylist.add(trackPath);
-                trackTitles.add(name);
-                trackLength.add(length);
+                addTrack(trackPath, length);
             }
         }
 
         // Updating the Playlist.txt
         updateFile(trackPlaylist);
+        analyseKeys(firstNewTrack);
 
         // Refresh the table component to display the newly added tracks
         tableComponent.updateContent();
@@ -213,12 +269,13 @@ void PlaylistComponent::textEditorTextChanged(juce::TextEditor& editor)
     // Getting the text in the text editor
     search = findFile.getText();
 
-    for (int i = 0; i < trackTitles.size(); ++i) {
-        if (trackTitles[i].containsWholeWordIgnoreCase(search) == 1 && search != "") {
+    for (int i = 0; i < getNumRows(); ++i) {
+        const String trackTitle = trackPlaylist.getTitle(getTrackIndex(i));
+        if (trackTitle.containsWholeWordIgnoreCase(search) == 1 && search != "") {
             // Highlight the row when the user types in a word that matches the track titles
             tableComponent.selectRow(i, false, true);
         }
-        else if (search == "" || trackTitles[i].containsWholeWordIgnoreCase(search) == -1) {
+        else if (search == "" || trackTitle.containsWholeWordIgnoreCase(search) == -1) {
             // Deselect all rows when nothing is typed
             tableComponent.deselectAllRows();
         }
@@ -228,9 +285,11 @@ void PlaylistComponent::textEditorTextChanged(juce::TextEditor& editor)
 void PlaylistComponent::remove()
 {
     // removing the track from the arrays based on the row index
-    trackPlaylist.remove(rowIndex);
-    trackTitles.remove(rowIndex);
-    trackLength.remove(rowIndex);
+    const int track = getTrackIndex(rowIndex);
+    trackPlaylist.remove(track);
+    trackLength.remove(track);
+    trackKeys.remove(track);
+    updateFilter();
 
     // Refresh the table component to display the changes
     tableComponent.updateContent();
@@ -254,29 +313,99 @@ String PlaylistComponent::convert(double length)
 
 double PlaylistComponent::duration(File chosen)
 {
-    // Creating a reader for the file
-    AudioFormatReader* reader = formatManager.createReaderFor(chosen);
+    TraceSpan span("PlaylistComponent::duration");
 
-    // Getting the length of the track and returning it
-    double length = reader->lengthInSamples / reader->sampleRate;
-    return length;
+    // Getting the length of the track from a pooled reader, which goes back to the pool straight away
+    return decoders->getLengthInSeconds(chosen);
 }
 
-String PlaylistComponent::title(File chosen)
+void PlaylistComponent::updateFile(const TrackStore& trackPlaylist)
 {
-    // Getting the track title and returning it
-    String tracktitle = juce::URL::removeEscapeChars(juce::URL{ chosen }.getFileName());
-    return tracktitle;
+    // Writing to playlist.txt with each track's length, so the library can be shown at startup without opening
+    // any track. The tracks that come from the watched folders are left out
+    std::ofstream playlist("Playlist.txt");
+    for (int i = 0; i < trackPlaylist.size(); i++) {
+        const String trackPath = trackPlaylist.getPath(i);
+        if (libraryWatcher.isInWatchedFolder(File(trackPath))) {
+            continue;
+        }
+        if (trackLength[i] >= 0) {
+            playlist << String(trackLength[i], 3) << "\t";
+        }
+        playlist << trackPath << std::endl;
+    }
+    playlist.close();
 }
 
-void PlaylistComponent::updateFile(Array<String> trackPlaylist)
+void PlaylistComponent::warmUpCaches()
 {
-    // Writing to playlist.txt
-    std::ofstream playlist("Playlist.txt");
+    TraceSpan span("PlaylistComponent::warmUpCaches");
+
+    // The keys found in earlier runs fill in the Key column, and the rest are analysed in the background
+    keyLibrary.loadCache();
     for (int i = 0; i < trackPlaylist.size(); i++) {
-        playlist << trackPlaylist[i] << std::endl;
+        trackKeys.set(i, keyLibrary.getKey(File(trackPlaylist.getPath(i))));
+    }
+    analyseKeys(0);
+    updateFilter();
+
+    // The tracks saved without a length are opened on the pool a batch at a time
+    Array<File> batch;
+    for (int i = 0; i < trackPlaylist.size(); i++) {
+        if (trackLength[i] >= 0) {
+            continue;
+        }
+        batch.add(File(trackPlaylist.getPath(i)));
+        if (batch.size() >= lengthBatchSize) {
+            queueLengths(batch);
+            batch.clearQuick();
+        }
+    }
+    queueLengths(batch);
+}
+
+void PlaylistComponent::queueLengths(const Array<File>& tracks)
+{
+    if (tracks.isEmpty()) {
+        return;
+    }
+
+    pendingLengthBatches++;
+
+    Component::SafePointer<PlaylistComponent> safeThis(this);
+    lengthPool.addJob([this, safeThis, tracks] {
+        TraceSpan span("PlaylistComponent lengths");
+
+        Array<double> lengths;
+        for (auto& track : tracks) {
+            if (stopping) {
+                return;
+            }
+            lengths.add(decoders->getLengthInSeconds(track));
+        }
+
+        MessageManager::callAsync([safeThis, tracks, lengths] {
+            if (safeThis != nullptr) {
+                safeThis->lengthsFound(tracks, lengths);
+            }
+        });
+    });
+}
+
+void PlaylistComponent::lengthsFound(const Array<File>& tracks, const Array<double>& lengths)
+{
+    for (int i = 0; i < tracks.size(); i++) {
+        const int track = trackPlaylist.indexOf(tracks[i].getFullPathName());
+        if (track >= 0) {
+            trackLength.set(track, lengths[i]);
+        }
+    }
+    tableComponent.repaint();
+
+    // Playlist.txt is written once the last batch is in, so the lengths are saved for next time
+    if (--pendingLengthBatches == 0) {
+        updateFile(trackPlaylist);
     }
-    playlist.close();
 }
 
 void PlaylistComponent::selectMainComponent(MainComponent* mainComponent)
@@ -288,7 +417,7 @@ void PlaylistComponent::selectMainComponent(MainComponent* mainComponent)
 void PlaylistComponent::addDeck1()
 {
     // Converting the String to a URL
-    String track = trackPlaylist[rowIndex];
+    String track = trackPlaylist.getPath(getTrackIndex(rowIndex));
     File trackChosen = File(track);
     URL fileURL = URL{ trackChosen };
 
@@ -299,7 +428,7 @@ void PlaylistComponent::addDeck1()
 void PlaylistComponent::addDeck2()
 {
     // Converting the String to a URL
-    String track = trackPlaylist[rowIndex];
+    String track = trackPlaylist.getPath(getTrackIndex(rowIndex));
     File trackChosen = File(track);
     URL fileURL = URL{ trackChosen };
 
@@ -307,6 +436,223 @@ void PlaylistComponent::addDeck2()
     mainComponent->deckGUIPlay(fileURL, 2);
 }
 
+void PlaylistComponent::toggleAutoDJ()
+{
+    if (mainComponent == nullptr) {
+        return;
+    }
+
+    if (mainComponent->isAutoDJRunning()) {
+        mainComponent->stopAutoDJ();
+        autoDJButton.setButtonText("AUTO DJ");
+        return;
+    }
+
+    // The queue runs from the selected track, or the first track, to the end of the playlist or the filtered tracks
+    int firstRow = jmax(0, tableComponent.getSelectedRow());
+    Array<File> queue;
+    for (int i = firstRow; i < getNumRows(); i++) {
+        queue.add(File(trackPlaylist.getPath(getTrackIndex(i))));
+    }
+
+    mainComponent->startAutoDJ(queue);
+    if (mainComponent->isAutoDJRunning()) {
+        autoDJButton.setButtonText("STOP AUTO DJ");
+    }
+}
+
+void PlaylistComponent::toggleRecording()
+{
+    if (mainComponent == nullptr) {
+        return;
+    }
+
+    if (mainComponent->isRecording()) {
+        mainComponent->stopRecording();
+        recordButton.setButtonText("REC");
+        recordButton.removeColour(TextButton::buttonColourId);
+        return;
+    }
+
+    // Asking which format to record to
+    PopupMenu menu;
+    menu.addItem(1, "Record to WAV");
+    menu.addItem(2, "Record to FLAC");
+    menu.showMenuAsync(PopupMenu::Options().withTargetComponent(&recordButton), [this](int result) {
+        if (result == 0 || mainComponent == nullptr) {
+            return;
+        }
+        mainComponent->startRecording(result == 2);
+        if (mainComponent->isRecording()) {
+            recordButton.setButtonText("STOP REC");
+            recordButton.setColour(TextButton::buttonColourId, Colours::darkred);
+        }
+    });
+}
+
+void PlaylistComponent::showWatchedFolders()
+{
+    // Listing the watched folders, picking one stops watching it
+    PopupMenu menu;
+    menu.addItem(1, "Watch a folder...");
+    Array<File> folders = libraryWatcher.getFolders();
+    if (!folders.isEmpty()) {
+        menu.addSeparator();
+        for (int i = 0; i < folders.size(); i++) {
+            menu.addItem(i + 2, "Stop watching " + folders[i].getFullPathName());
+        }
+    }
+
+    menu.showMenuAsync(PopupMenu::Options().withTargetComponent(&foldersButton), [this, folders](int result) {
+        if (result == 1) {
+            folderChooser.launchAsync(FileBrowserComponent::openMode | FileBrowserComponent::canSelectDirectories,
+                                      [this](const FileChooser& chooser) {
+                if (chooser.getResult().isDirectory()) {
+                    libraryWatcher.addFolder(chooser.getResult());
+                }
+            });
+        }
+        else if (result >= 2) {
+            libraryWatcher.removeFolder(folders[result - 2]);
+        }
+    });
+}
+
+void PlaylistComponent::applyLibraryChanges(const LibraryWatcher::Changes& changes)
+{
+    TraceSpan span("PlaylistComponent::applyLibraryChanges");
+
+    // Looking up the removed and renamed tracks by path, so a big change is one pass over the playlist
+    std::unordered_set<String> removed;
+    for (auto& file : changes.removed) {
+        removed.insert(file.getFullPathName());
+    }
+    std::unordered_map<String, File> renamed;
+    for (auto& move : changes.moved) {
+        renamed[move.from.getFullPathName()] = move.to;
+    }
+
+    // The library is stored again from scratch, which also gives back the space of the names that went
+    TrackStore newPlaylist;
+    Array<double> newLengths;
+    Array<int> newKeys;
+    for (int i = 0; i < trackPlaylist.size(); i++) {
+        const String trackPath = trackPlaylist.getPath(i);
+        if (removed.count(trackPath) > 0) {
+            continue;
+        }
+        auto move = renamed.find(trackPath);
+        newPlaylist.add(move != renamed.end() ? move->second.getFullPathName() : trackPath);
+        newLengths.add(trackLength[i]);
+        newKeys.add(trackKeys[i]);
+    }
+
+    trackPlaylist.swapWith(newPlaylist);
+    trackLength.swapWith(newLengths);
+    trackKeys.swapWith(newKeys);
+
+    // Adding the new tracks with the lengths the watcher already read
+    const int firstNewTrack = trackPlaylist.size();
+    for (auto& track : changes.added) {
+        const String trackPath = track.file.getFullPathName();
+        if (!trackPlaylist.contains(trackPath)) {
+            addTrack(trackPath, track.lengthInSeconds);
+        }
+    }
+
+    updateFile(trackPlaylist);
+    analyseKeys(firstNewTrack);
+    updateFilter();
+    tableComponent.updateContent();
+    tableComponent.repaint();
+}
+
+void PlaylistComponent::showPlaylistMenu()
+{
+    PopupMenu menu;
+    if (playlistImporter.isImporting()) {
+        menu.addItem(1, "Stop importing");
+    }
+    else {
+        menu.addItem(2, "Import M3U or rekordbox XML...");
+    }
+    menu.addSeparator();
+    menu.addItem(3, "Export as M3U8...", !trackPlaylist.isEmpty());
+    menu.addItem(4, "Export as rekordbox XML...", !trackPlaylist.isEmpty());
+
+    menu.showMenuAsync(PopupMenu::Options().withTargetComponent(&playlistButton), [this](int result) {
+        if (result == 1) {
+            playlistImporter.cancel();
+            importFinished(File(), 0);
+        }
+        else if (result == 2) {
+            playlistChooser = std::make_unique<FileChooser>("Select a playlist to import...", File(), "*.m3u;*.m3u8;*.xml");
+            playlistChooser->launchAsync(FileBrowserComponent::openMode | FileBrowserComponent::canSelectFiles,
+                                         [this](const FileChooser& chooser) {
+                if (chooser.getResult().existsAsFile()) {
+                    importPlaylist(chooser.getResult());
+                }
+            });
+        }
+        else if (result == 3 || result == 4) {
+            exportPlaylist(result == 4);
+        }
+    });
+}
+
+void PlaylistComponent::importPlaylist(const File& playlistFile)
+{
+    playlistImporter.startImport(playlistFile);
+    playlistButton.setButtonText("IMPORTING...");
+}
+
+void PlaylistComponent::addImportedTracks(const Array<PlaylistImporter::Track>& tracks)
+{
+    TraceSpan span("PlaylistComponent::addImportedTracks");
+
+    const int firstNewTrack = trackPlaylist.size();
+    for (auto& track : tracks) {
+        const String trackPath = track.file.getFullPathName();
+        if (!trackPlaylist.contains(trackPath)) {
+            // A negative length is unknown, so it is left out of Playlist.txt and found again at the next start
+            addTrack(trackPath, track.lengthInSeconds);
+        }
+    }
+    analyseKeys(firstNewTrack);
+    tableComponent.updateContent();
+}
+
+void PlaylistComponent::importFinished(const File& playlistFile, int numImported)
+{
+    if (playlistFile != File()) {
+        DBG("Imported " + String(numImported) + " tracks from " + playlistFile.getFullPathName());
+    }
+
+    // Playlist.txt is written once at the end rather than after every batch
+    updateFile(trackPlaylist);
+    tableComponent.updateContent();
+    playlistButton.setButtonText("PLAYLISTS");
+}
+
+void PlaylistComponent::exportPlaylist(bool asXml)
+{
+    const File defaultFile = File::getSpecialLocation(File::userMusicDirectory).getChildFile(asXml ? "OtoDecks.xml" : "OtoDecks.m3u8");
+    playlistChooser = std::make_unique<FileChooser>("Export the library as...", defaultFile, asXml ? "*.xml" : "*.m3u8;*.m3u");
+    playlistChooser->launchAsync(FileBrowserComponent::saveMode | FileBrowserComponent::warnAboutOverwriting,
+                                 [this, asXml](const FileChooser& chooser) {
+        const File target = chooser.getResult();
+        if (target == File()) {
+            return;
+        }
+
+        const bool written = asXml ? PlaylistExporter::writeXml(target, trackPlaylist, trackLength)
+                                   : PlaylistExporter::writeM3U(target, trackPlaylist, trackLength);
+        if (!written) {
+            DBG("Could not export the library to " + target.getFullPathName());
+        }
+    });
+}
+
 bool PlaylistComponent::isInterestedInFileDrag(const StringArray& files)
 {
     std::cout << "DeckGUI::isInterestedInFileDrag" << std::endl;
@@ -315,16 +661,110 @@ bool PlaylistComponent::isInterestedInFileDrag(const StringArray& files)
 
 void PlaylistComponent::filesDropped(const StringArray& files, int x, int y)
 {
+    TraceSpan span("PlaylistComponent::filesDropped");
+
+    const int firstNewTrack = trackPlaylist.size();
     for (int i = 0; i < files.size(); i++) {
-        if (trackPlaylist.indexOf(files[i]) != -1) {
+        // A dropped playlist is imported instead of being added as a track
+        if (PlaylistImporter::canImport(File(files[i]))) {
+            importPlaylist(File(files[i]));
+        }
+        else if (trackPlaylist.contains(files[i])) {
             DBG("File is already in playlist");
         }
         else {
-            trackPlaylist.add(files[i]);
-            trackTitles.add(title(files[i]));
-            trackLength.add(duration(files[i]));
+            addTrack(files[i], duration(files[i]));
         }
     }
     updateFile(trackPlaylist);
+    analyseKeys(firstNewTrack);
+    tableComponent.updateContent();
+}
+
+void PlaylistComponent::deckTrackChanged(int deck)
+{
+    if (deck == compatibleDeck) {
+        updateFilter();
+    }
+}
+
+void PlaylistComponent::addTrack(const String& trackPath, double length)
+{
+    trackPlaylist.add(trackPath);
+    trackLength.add(length);
+    trackKeys.add(keyLibrary.getKey(File(trackPath)));
+}
+
+void PlaylistComponent::analyseKeys(int firstTrack)
+{
+    Array<File> tracks;
+    for (int i = firstTrack; i < trackPlaylist.size(); i++) {
+        if (trackKeys[i] < 0) {
+            tracks.add(File(trackPlaylist.getPath(i)));
+        }
+    }
+    keyLibrary.analyse(tracks);
+}
+
+void PlaylistComponent::keysFound(const Array<KeyLibrary::Result>& results)
+{
+    for (auto& result : results) {
+        const int track = trackPlaylist.indexOf(result.file.getFullPathName());
+        if (track >= 0) {
+            trackKeys.set(track, result.key);
+        }
+    }
+
+    // The deck's own track may be one of them, so the filter is worked out again
+    if (compatibleDeck != 0) {
+        updateFilter();
+    }
+    tableComponent.repaint();
+}
+
+void PlaylistComponent::showKeyMenu()
+{
+    PopupMenu menu;
+    menu.addItem(1, "Show all tracks", true, compatibleDeck == 0);
+    for (int deck = 1; deck <= 2; deck++) {
+        const bool hasTrack = mainComponent != nullptr && mainComponent->getDeckTrack(deck).existsAsFile();
+        menu.addItem(deck + 1, "Compatible with deck " + String(deck), hasTrack, compatibleDeck == deck);
+    }
+
+    menu.showMenuAsync(PopupMenu::Options().withTargetComponent(&keyButton), [this](int result) {
+        if (result == 0) {
+            return;
+        }
+        compatibleDeck = result - 1;
+        keyButton.setButtonText(compatibleDeck == 0 ? "KEY" : "KEY: DECK " + String(compatibleDeck));
+        tableComponent.deselectAllRows();
+        updateFilter();
+    });
+}
+
+void PlaylistComponent::updateFilter()
+{
+    // Only the cached keys are compared, so this is a pass over an array of ints however big the library is
+    visibleRows.clearQuick();
+    if (compatibleDeck != 0 && mainComponent != nullptr) {
+        const File deckTrack = mainComponent->getDeckTrack(compatibleDeck);
+        const int deckKey = keyLibrary.getKey(deckTrack);
+        if (deckKey < 0 && deckTrack.existsAsFile()) {
+            // The list fills in once the deck's key is found
+            keyLibrary.analyse({ deckTrack });
+        }
+
+        for (int i = 0; i < trackKeys.size(); i++) {
+            if (KeyDetector::areCompatible(deckKey, trackKeys[i])) {
+                visibleRows.add(i);
+            }
+        }
+    }
     tableComponent.updateContent();
+    tableComponent.repaint();
+}
+
+int PlaylistComponent::getTrackIndex(int row) const
+{
+    return compatibleDeck == 0 ? row : visibleRows[row];
 }
\ No newline at end of file
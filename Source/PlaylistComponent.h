@@ -16,6 +16,11 @@
 #include <iostream>
 #include <fstream> 
 #include "DJAudioPlayer.h"
+#include "DecoderService.h"
+#include "KeyLibrary.h"
+#include "LibraryWatcher.h"
+#include "PlaylistImporter.h"
+#include "TrackStore.h"
 
 //==============================================================================
 /*
@@ -41,6 +46,9 @@ public:
 
     Component* refreshComponentForCell(int rowNumber, int columnId, bool isRowSelected, Component* existingComponentToUpdate) override;
 
+    // Function to warm up the selected track and the one after it
+    void selectedRowsChanged(int lastRowSelected) override;
+
     void buttonClicked(Button* button) override;
 
     // Function to check whether the text editor has changed
@@ -55,11 +63,8 @@ public:
     // Function to get the length of the track
     double duration(File chosen);
 
-    // Function to get the title of the track
-    String title(File chosen);
-
     // Function to update the txt file
-    void updateFile(Array<String> trackPlaylist);
+    void updateFile(const TrackStore& trackPlaylist);
 
     bool isInterestedInFileDrag(const StringArray& files) override;
     void filesDropped(const StringArray& files, int x, int y) override;
@@ -71,18 +76,86 @@ public:
     void addDeck1();
     void addDeck2();
 
+    // Function to start the auto DJ from the selected track, or stop it when it is running
+    void toggleAutoDJ();
+
+    // Function to start recording the master output, or stop it when it is recording
+    void toggleRecording();
+
+    // Function to show the watched folders, with options to add one or stop watching one
+    void showWatchedFolders();
+
+    // Function to add, remove and rename the tracks that changed in the watched folders
+    void applyLibraryChanges(const LibraryWatcher::Changes& changes);
+
+    // Function to show the playlist import and export options
+    void showPlaylistMenu();
+
+    // Function to import an M3U, M3U8 or rekordbox XML file into the library in the background
+    void importPlaylist(const File& playlistFile);
+
+    // Function to add a batch of imported tracks, skipping the ones already in the library
+    void addImportedTracks(const Array<PlaylistImporter::Track>& tracks);
+
+    // Function to save the library once an import has finished
+    void importFinished(const File& playlistFile, int numImported);
+
+    // Function to ask where to export the library to, as an M3U8 playlist or a rekordbox XML collection
+    void exportPlaylist(bool asXml);
+
+    // Function to refresh the key filter when it follows the deck that just loaded a track
+    void deckTrackChanged(int deck);
+
+    // Function to load the key cache and find the missing keys and lengths, called once the window is showing
+    void warmUpCaches();
+
 private:
-    AudioFormatManager formatManager;
-    MainComponent* mainComponent;
+    // Function to add a track to the end of the library with its length and its cached key
+    void addTrack(const String& trackPath, double length);
+
+    // Function to queue the key analysis of the tracks from firstTrack on that do not have a key yet
+    void analyseKeys(int firstTrack);
+
+    // Function to fill in the keys found in the background
+    void keysFound(const Array<KeyLibrary::Result>& results);
+
+    // Function to show the key filter options
+    void showKeyMenu();
+
+    // Function to list the tracks that mix well with the deck the filter follows
+    void updateFilter();
+
+    // Function to get the track shown in a row, which is the same as the row unless the key filter is on
+    int getTrackIndex(int row) const;
+
+    // Function to open a batch of tracks on the pool to find their lengths
+    void queueLengths(const Array<File>& tracks);
+
+    // Function to fill in the lengths found in the background
+    void lengthsFound(const Array<File>& tracks, const Array<double>& lengths);
+
+    SharedResourcePointer<DecoderService> decoders;
+    MainComponent* mainComponent = nullptr;
 
     TableListBox tableComponent;
 
-    Array<String> trackTitles;
-    Array<String> trackPlaylist;
+    // Paths are stored by folder and file name, and the titles are the file names in the store
+    TrackStore trackPlaylist;
     Array<double> trackLength;
+    Array<int> trackKeys;
+
+    // The deck the key filter follows, 0 when every track is shown, and the tracks it shows
+    int compatibleDeck = 0;
+    Array<int> visibleRows;
 
     String search;
     TextButton loadButton{ "LOAD" };
+    TextButton autoDJButton{ "AUTO DJ" };
+    TextButton settingsButton{ "AUDIO SETTINGS" };
+    TextButton recordButton{ "REC" };
+    TextButton foldersButton{ "FOLDERS" };
+    TextButton playlistButton{ "PLAYLISTS" };
+    TextButton keyButton{ "KEY" };
     int rowIndex;
 
     bool is_empty(std::ifstream& pFile)
@@ -91,6 +164,26 @@ private:
     }
 
     FileChooser fChooser{ "Select a file..." , File(), "*.mp3", true, false };
+    FileChooser folderChooser{ "Select a folder to watch..." };
+    std::unique_ptr<FileChooser> playlistChooser;
+
+    // Tracks in the watched folders are kept up to date by the watcher, and are not saved to Playlist.txt
+    LibraryWatcher libraryWatcher{ [this](const LibraryWatcher::Changes& changes) { applyLibraryChanges(changes); } };
+
+    // Imported tracks arrive in batches on the message thread
+    PlaylistImporter playlistImporter{ [this](const Array<PlaylistImporter::Track>& tracks) { addImportedTracks(tracks); },
+                                       [this](const File& playlistFile, int numImported) { importFinished(playlistFile, numImported); } };
+
+    // Keys are found on a pool when tracks join the library and cached between runs
+    KeyLibrary keyLibrary{ [this](const Array<KeyLibrary::Result>& results) { keysFound(results); } };
+
+    // Tracks saved without a length are opened here after startup, a batch per job
+    static constexpr int lengthBatchSize = 64;
+    std::atomic<bool> stopping{ false };
+    ThreadPool lengthPool{ 1 };
+
+    // Batches queued whose lengths have not reached the message thread yet, Playlist.txt is saved when it is back to 0
+    int pendingLengthBatches = 0;
 
     juce::TextEditor findFile{ "Search" };
 
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    PlaylistExporter.cpp
+    Created: 21 Oct 2026 11:03:52am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PlaylistExporter.h"
+#include "Tracer.h"
+
+//==============================================================================
+bool PlaylistExporter::writeM3U(const File& target, const TrackStore& tracks, const Array<double>& lengths)
+{
+    TraceSpan span("PlaylistExporter::writeM3U");
+
+    TemporaryFile temp(target);
+    {
+        FileOutputStream output(temp.getFile());
+        if (!output.openedOk()) {
+            return false;
+        }
+
+        output << "#EXTM3U\n";
+        for (int i = 0; i < tracks.size(); i++) {
+            // -1 tells the reader the length is not known
+            const int seconds = lengths[i] > 0 ? roundToInt(lengths[i]) : -1;
+            const String path = tracks.getPath(i);
+            output << "#EXTINF:" << seconds << "," << File(path).getFileNameWithoutExtension() << "\n"
+                   << path << "\n";
+        }
+
+        output.flush();
+        if (output.getStatus().failed()) {
+            return false;
+        }
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+bool PlaylistExporter::writeXml(const File& target, const TrackStore& tracks, const Array<double>& lengths)
+{
+    TraceSpan span("PlaylistExporter::writeXml");
+
+    TemporaryFile temp(target);
+    {
+        FileOutputStream output(temp.getFile());
+        if (!output.openedOk()) {
+            return false;
+        }
+
+        output << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               << "<DJ_PLAYLISTS Version=\"1.0.0\">\n"
+               << "  <PRODUCT Name=\"OtoDecks\" Version=\"" << ProjectInfo::versionString << "\" Company=\"\"/>\n"
+               << "  <COLLECTION Entries=\"" << tracks.size() << "\">\n";
+
+        // Track IDs start at 1, and the playlist below refers to the tracks by them
+        for (int i = 0; i < tracks.size(); i++) {
+            const String path = tracks.getPath(i);
+            output << "    <TRACK TrackID=\"" << (i + 1)
+                   << "\" Name=\"" << escapeAttribute(File(path).getFileNameWithoutExtension())
+                   << "\" TotalTime=\"" << (lengths[i] > 0 ? roundToInt(lengths[i]) : 0)
+                   << "\" Location=\"" << escapeAttribute(fileToUrl(path)) << "\"/>\n";
+        }
+
+        output << "  </COLLECTION>\n"
+               << "  <PLAYLISTS>\n"
+               << "    <NODE Type=\"0\" Name=\"ROOT\" Count=\"1\">\n"
+               << "      <NODE Name=\"OtoDecks\" Type=\"1\" KeyType=\"0\" Entries=\"" << tracks.size() << "\">\n";
+        for (int i = 0; i < tracks.size(); i++) {
+            output << "        <TRACK Key=\"" << (i + 1) << "\"/>\n";
+        }
+        output << "      </NODE>\n"
+               << "    </NODE>\n"
+               << "  </PLAYLISTS>\n"
+               << "</DJ_PLAYLISTS>\n";
+
+        output.flush();
+        if (output.getStatus().failed()) {
+            return false;
+        }
+    }
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+String PlaylistExporter::fileToUrl(const String& path)
+{
+    // Keeping the letters, digits and separators, and percent encoding the UTF-8 of everything else
+   #if JUCE_WINDOWS
+    const String forwardPath = path.replaceCharacter('\\', '/');
+   #else
+    const String forwardPath = path;
+   #endif
+    const char* utf8 = forwardPath.toRawUTF8();
+    const char* hexDigits = "0123456789ABCDEF";
+
+    String url("file://localhost");
+    if (!forwardPath.startsWith("/")) {
+        url << "/";
+    }
+    for (size_t i = 0; utf8[i] != 0; ++i) {
+        const auto c = (unsigned char) utf8[i];
+        if (c < 128 && CharacterFunctions::isLetterOrDigit((char) c)) {
+            url << (char) c;
+        }
+        else if (c == '/' || c == '-' || c == '.' || c == '_' || c == '~' || c == ':') {
+            url << (char) c;
+        }
+        else {
+            url << '%' << hexDigits[c >> 4] << hexDigits[c & 15];
+        }
+    }
+    return url;
+}
+
+String PlaylistExporter::escapeAttribute(const String& text)
+{
+    return text.replace("&", "&amp;")
+               .replace("\"", "&quot;")
+               .replace("<", "&lt;")
+               .replace(">", "&gt;");
+}
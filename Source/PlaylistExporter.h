@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    PlaylistExporter.h
+    Created: 21 Oct 2026 11:03:52am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackStore.h"
+
+//==============================================================================
+/*
+    Writes the library out for other DJ software, as an M3U8 playlist or a
+    rekordbox XML collection.
+
+    Each track is written straight to the file as it is reached, without
+    building the document in memory first. The file is written next to the
+    target and moved over it at the end, so a failed export never leaves a
+    half written playlist behind.
+*/
+class PlaylistExporter
+{
+public:
+    /** write the tracks as an M3U8 playlist with their lengths and titles */
+    static bool writeM3U(const File& target, const TrackStore& tracks, const Array<double>& lengths);
+
+    /** write the tracks as a rekordbox XML collection, with a playlist holding all of them in order */
+    static bool writeXml(const File& target, const TrackStore& tracks, const Array<double>& lengths);
+
+private:
+    // Function to turn a path into the file://localhost/ URL the XML uses, encoding each part of the path
+    static String fileToUrl(const String& path);
+
+    // Function to escape the characters that cannot appear in a quoted attribute
+    static String escapeAttribute(const String& text);
+};
@@ -0,0 +1,587 @@
+/*
+  ==============================================================================
+
+    PlaylistImporter.cpp
+    Created: 21 Oct 2026 10:12:37am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PlaylistImporter.h"
+#include "Tracer.h"
+
+#include <string>
+#include <vector>
+
+//==============================================================================
+namespace
+{
+    // Reads a stream in chunks, keeping only the part that has not been parsed yet
+    class StreamBuffer
+    {
+    public:
+        explicit StreamBuffer(InputStream& streamToRead) : stream(streamToRead) {}
+
+        // Function to find text from an offset past the read position, reading more until it turns up
+        size_t find(const char* text, size_t offset = 0)
+        {
+            const size_t length = strlen(text);
+            for (;;) {
+                const size_t found = data.find(text, position + offset);
+                if (found != std::string::npos) {
+                    return found - position;
+                }
+
+                // Searching again from the end, in case the text is split between two chunks
+                const size_t available = data.size() - position;
+                offset = jmax(offset, available >= length ? available - length + 1 : (size_t) 0);
+                if (!readMore()) {
+                    return std::string::npos;
+                }
+            }
+        }
+
+        // Function to get the byte at an offset past the read position, 0 at the end of the stream
+        char peek(size_t offset)
+        {
+            while (data.size() - position <= offset) {
+                if (!readMore()) {
+                    return 0;
+                }
+            }
+            return data[position + offset];
+        }
+
+        bool startsWith(const char* text)
+        {
+            for (size_t i = 0; text[i] != 0; ++i) {
+                if (peek(i) != text[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::string take(size_t numBytes)
+        {
+            numBytes = jmin(numBytes, data.size() - position);
+            std::string taken = data.substr(position, numBytes);
+            position += numBytes;
+            return taken;
+        }
+
+        void skip(size_t numBytes)
+        {
+            position = jmin(data.size(), position + numBytes);
+        }
+
+        // Function to take everything left in the stream
+        std::string takeRest()
+        {
+            while (readMore()) {}
+            return take(data.size() - position);
+        }
+
+        bool isFinished()
+        {
+            return position >= data.size() && !readMore();
+        }
+
+        // True if a line or tag was too long to be anything but a broken file
+        bool hasFailed() const
+        {
+            return failed;
+        }
+
+    private:
+        bool readMore()
+        {
+            // A token longer than this is never going to end, so the stream is treated as finished
+            if (data.size() - position > maxTokenBytes) {
+                failed = true;
+                return false;
+            }
+
+            if (position > 0) {
+                data.erase(0, position);
+                position = 0;
+            }
+
+            const size_t oldSize = data.size();
+            data.resize(oldSize + chunkSize);
+            const int numRead = stream.read(&data[oldSize], chunkSize);
+            data.resize(oldSize + (size_t) jmax(0, numRead));
+            return numRead > 0;
+        }
+
+        static constexpr int chunkSize = 65536;
+        static constexpr size_t maxTokenBytes = 1 << 20;
+
+        InputStream& stream;
+        std::string data;
+        size_t position = 0;
+        bool failed = false;
+    };
+
+    // A start or end tag, with its attributes still escaped
+    struct XmlTag
+    {
+        std::string name;
+        bool isEnd = false;
+        bool isSelfClosing = false;
+        std::vector<std::pair<std::string, std::string>> attributes;
+
+        String getAttribute(const char* attributeName) const;
+    };
+
+    // Function to replace the five XML entities and character references in an attribute
+    String decodeEntities(const std::string& text)
+    {
+        std::string decoded;
+        decoded.reserve(text.size());
+
+        for (size_t i = 0; i < text.size(); ++i) {
+            const size_t end = text[i] == '&' ? text.find(';', i) : std::string::npos;
+            if (end == std::string::npos || end - i > 10) {
+                decoded += text[i];
+                continue;
+            }
+
+            const std::string entity = text.substr(i + 1, end - i - 1);
+            if (entity == "amp") decoded += '&';
+            else if (entity == "lt") decoded += '<';
+            else if (entity == "gt") decoded += '>';
+            else if (entity == "quot") decoded += '"';
+            else if (entity == "apos") decoded += '\'';
+            else if (entity.size() > 1 && entity[0] == '#') {
+                const bool hex = entity[1] == 'x' || entity[1] == 'X';
+                const auto code = (juce_wchar) std::strtoul(entity.c_str() + (hex ? 2 : 1), nullptr, hex ? 16 : 10);
+                decoded += String::charToString(code).toStdString();
+            }
+            else {
+                decoded += text.substr(i, end - i + 1);
+            }
+            i = end;
+        }
+        return String::fromUTF8(decoded.data(), (int) decoded.size());
+    }
+
+    String XmlTag::getAttribute(const char* attributeName) const
+    {
+        for (auto& attribute : attributes) {
+            if (attribute.first == attributeName) {
+                return decodeEntities(attribute.second);
+            }
+        }
+        return {};
+    }
+
+    // Function to split the text of a tag into its name and attributes
+    void parseTag(const std::string& text, XmlTag& tag)
+    {
+        tag.attributes.clear();
+        tag.isEnd = text.size() > 1 && text[1] == '/';
+        tag.isSelfClosing = text.size() > 2 && text[text.size() - 2] == '/';
+
+        auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+        size_t i = tag.isEnd ? 2 : 1;
+        const size_t nameStart = i;
+        while (i < text.size() && !isSpace(text[i]) && text[i] != '/' && text[i] != '>') {
+            ++i;
+        }
+        tag.name = text.substr(nameStart, i - nameStart);
+
+        while (i < text.size()) {
+            while (i < text.size() && (isSpace(text[i]) || text[i] == '/' || text[i] == '>')) {
+                ++i;
+            }
+            const size_t attributeStart = i;
+            while (i < text.size() && !isSpace(text[i]) && text[i] != '=' && text[i] != '>') {
+                ++i;
+            }
+            if (i == attributeStart) {
+                break;
+            }
+            std::string attributeName = text.substr(attributeStart, i - attributeStart);
+
+            while (i < text.size() && (isSpace(text[i]) || text[i] == '=')) {
+                ++i;
+            }
+            if (i >= text.size() || (text[i] != '"' && text[i] != '\'')) {
+                continue;
+            }
+            const size_t valueEnd = text.find(text[i], i + 1);
+            if (valueEnd == std::string::npos) {
+                break;
+            }
+            tag.attributes.emplace_back(std::move(attributeName), text.substr(i + 1, valueEnd - i - 1));
+            i = valueEnd + 1;
+        }
+    }
+
+    // Function to read the next start or end tag, skipping text, comments and declarations
+    bool readTag(StreamBuffer& buffer, XmlTag& tag)
+    {
+        for (;;) {
+            const size_t start = buffer.find("<");
+            if (start == std::string::npos) {
+                return false;
+            }
+            buffer.skip(start);
+
+            const char* skipUntil = buffer.startsWith("<!--") ? "-->"
+                                  : buffer.startsWith("<![CDATA[") ? "]]>"
+                                  : buffer.startsWith("<?") ? "?>"
+                                  : buffer.startsWith("<!") ? ">"
+                                  : nullptr;
+            if (skipUntil != nullptr) {
+                const size_t end = buffer.find(skipUntil, 2);
+                if (end == std::string::npos) {
+                    return false;
+                }
+                buffer.skip(end + strlen(skipUntil));
+                continue;
+            }
+
+            // A quoted attribute may have a '>' in it, so the end of the tag is found outside the quotes
+            char quote = 0;
+            for (size_t i = 1;; ++i) {
+                const char c = buffer.peek(i);
+                if (c == 0) {
+                    return false;
+                }
+                if (quote != 0) {
+                    quote = c == quote ? 0 : quote;
+                }
+                else if (c == '"' || c == '\'') {
+                    quote = c;
+                }
+                else if (c == '>') {
+                    parseTag(buffer.take(i + 1), tag);
+                    return true;
+                }
+            }
+        }
+    }
+
+    // Function to undo percent encoding, leaving a '+' as it is because file URLs never use it for spaces
+    String percentDecode(const String& text)
+    {
+        const std::string encoded = text.toStdString();
+        std::string decoded;
+        decoded.reserve(encoded.size());
+
+        for (size_t i = 0; i < encoded.size(); ++i) {
+            if (encoded[i] == '%' && i + 2 < encoded.size() && isxdigit((unsigned char) encoded[i + 1])
+                && isxdigit((unsigned char) encoded[i + 2])) {
+                decoded += (char) std::strtol(encoded.substr(i + 1, 2).c_str(), nullptr, 16);
+                i += 2;
+            }
+            else {
+                decoded += encoded[i];
+            }
+        }
+        return String::fromUTF8(decoded.data(), (int) decoded.size());
+    }
+
+    // Function to turn a file:// URL into a file, such as file://localhost/Users/me/Music/a%20b.mp3
+    File fileFromUrl(const String& url)
+    {
+        String path;
+        if (url.startsWithIgnoreCase("file://localhost/")) {
+            path = url.substring(16);
+        }
+        else if (url.startsWithIgnoreCase("file://")) {
+            path = url.substring(7);
+        }
+        else {
+            return {};
+        }
+        path = percentDecode(path);
+
+       #if JUCE_WINDOWS
+        // file://localhost/C:/Music/a.mp3 has a slash in front of the drive
+        if (path.length() > 2 && path[0] == '/' && path[2] == ':') {
+            path = path.substring(1);
+        }
+        path = path.replaceCharacter('/', '\\');
+       #endif
+
+        return File::isAbsolutePath(path) ? File(path) : File();
+    }
+
+    // Function to decode a line of an M3U, which is UTF-8 in an .m3u8 and often Latin-1 in an old .m3u
+    String decodeLine(const std::string& line, bool utf8Only)
+    {
+        if (utf8Only || CharPointer_UTF8::isValidString(line.data(), (int) line.size())) {
+            return String::fromUTF8(line.data(), (int) line.size());
+        }
+
+        String latin1;
+        latin1.preallocateBytes(line.size() * 2);
+        for (unsigned char c : line) {
+            latin1 += (juce_wchar) c;
+        }
+        return latin1;
+    }
+}
+
+//==============================================================================
+PlaylistImporter::PlaylistImporter(std::function<void(const Array<Track>&)> onTracksImported,
+                                   std::function<void(const File&, int numImported)> onImportFinished)
+                                   : Thread("Playlist importer"),
+                                     onTracks(std::move(onTracksImported)),
+                                     onFinished(std::move(onImportFinished))
+{
+}
+
+PlaylistImporter::~PlaylistImporter()
+{
+    cancel();
+}
+
+bool PlaylistImporter::canImport(const File& file)
+{
+    return file.hasFileExtension("m3u;m3u8;xml");
+}
+
+void PlaylistImporter::startImport(const File& playlistFile)
+{
+    cancel();
+
+    playlist = playlistFile;
+    batch.clear();
+    nextSequence = 0;
+    {
+        const ScopedLock sl(pendingLock);
+        nextToPost = 0;
+        numImported = 0;
+    }
+    startThread(Thread::Priority::low);
+}
+
+void PlaylistImporter::cancel()
+{
+    stopThread(10000);
+    cancelPendingUpdate();
+
+    const ScopedLock sl(pendingLock);
+    finished.clear();
+    numBatches = -1;
+}
+
+bool PlaylistImporter::isImporting() const
+{
+    const ScopedLock sl(pendingLock);
+    return isThreadRunning() || numBatches >= 0;
+}
+
+void PlaylistImporter::run()
+{
+    TraceSpan span("PlaylistImporter import");
+
+    std::unique_ptr<FileInputStream> stream(playlist.createInputStream());
+    bool readOk = false;
+    {
+        ThreadPool pool(jmax(1, SystemStats::getNumCpus()));
+        if (stream != nullptr && stream->openedOk()) {
+            readOk = playlist.hasFileExtension("xml") ? readXml(*stream, pool) : readM3U(*stream, pool);
+            queueBatch(pool);
+        }
+
+        while (pool.getNumJobs() > 0) {
+            if (threadShouldExit()) {
+                pool.removeAllJobs(true, 10000);
+                return;
+            }
+            Thread::sleep(5);
+        }
+    }
+
+    if (!readOk) {
+        DBG("Could not read all of " + playlist.getFullPathName());
+    }
+
+    const ScopedLock sl(pendingLock);
+    numBatches = nextSequence;
+    triggerAsyncUpdate();
+}
+
+bool PlaylistImporter::readM3U(InputStream& stream, ThreadPool& pool)
+{
+    StreamBuffer buffer(stream);
+    const bool utf8Only = playlist.hasFileExtension("m3u8");
+    const File folder = playlist.getParentDirectory();
+    double extinfLength = -1;
+    bool firstLine = true;
+
+    while (!threadShouldExit() && !buffer.isFinished())
+    {
+        const size_t end = buffer.find("\n");
+        std::string bytes = end == std::string::npos ? buffer.takeRest() : buffer.take(end);
+        buffer.skip(1);
+        if (buffer.hasFailed()) {
+            return false;
+        }
+
+        if (firstLine && bytes.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+            bytes.erase(0, 3);
+        }
+        firstLine = false;
+
+        const String line = decodeLine(bytes, utf8Only).trim();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        // #EXTINF:<seconds>,<title> describes the next entry, -1 when the length is not known
+        if (line.startsWith("#")) {
+            if (line.startsWithIgnoreCase("#EXTINF:")) {
+                const double seconds = line.substring(8).upToFirstOccurrenceOf(",", false, false).getDoubleValue();
+                extinfLength = seconds > 0 ? seconds : -1;
+            }
+            continue;
+        }
+
+        File file;
+        if (line.startsWithIgnoreCase("file://")) {
+            file = fileFromUrl(line);
+        }
+        else if (!line.containsIgnoreCase("://")) {
+           #if JUCE_WINDOWS
+            const String path = line;
+           #else
+            const String path = line.replaceCharacter('\\', '/');
+           #endif
+            // Relative entries are relative to the folder the playlist is in
+            file = File::isAbsolutePath(path) ? File(path) : folder.getChildFile(path);
+        }
+
+        // Streams and anything else that is not a local file are left out of the library
+        if (file != File()) {
+            addTrack({ file, extinfLength }, pool);
+        }
+        extinfLength = -1;
+    }
+    return true;
+}
+
+bool PlaylistImporter::readXml(InputStream& stream, ThreadPool& pool)
+{
+    // Only the tracks in the COLLECTION are read, the PLAYLISTS only refer back to them
+    StreamBuffer buffer(stream);
+    XmlTag tag;
+    bool inCollection = false;
+
+    while (!threadShouldExit() && readTag(buffer, tag))
+    {
+        if (tag.name == "COLLECTION") {
+            inCollection = !tag.isEnd && !tag.isSelfClosing;
+        }
+        else if (inCollection && !tag.isEnd && tag.name == "TRACK") {
+            const File file = fileFromUrl(tag.getAttribute("Location"));
+            const String totalTime = tag.getAttribute("TotalTime");
+            if (file != File()) {
+                addTrack({ file, totalTime.getDoubleValue() > 0 ? totalTime.getDoubleValue() : -1 }, pool);
+            }
+        }
+    }
+    return !buffer.hasFailed();
+}
+
+void PlaylistImporter::addTrack(const Track& track, ThreadPool& pool)
+{
+    batch.add(track);
+    if (batch.size() >= batchSize) {
+        queueBatch(pool);
+    }
+}
+
+void PlaylistImporter::queueBatch(ThreadPool& pool)
+{
+    if (batch.isEmpty() || !waitForRoom()) {
+        batch.clear();
+        return;
+    }
+
+    const int sequence = nextSequence++;
+    Array<Track> tracks;
+    tracks.swapWith(batch);
+
+    bool needsLengths = false;
+    for (auto& track : tracks) {
+        needsLengths = needsLengths || track.lengthInSeconds < 0;
+    }
+    if (!needsLengths) {
+        post(sequence, std::move(tracks));
+        return;
+    }
+
+    // The batch is opened on the pool while the next one is being parsed
+    pool.addJob([this, sequence, tracks]() mutable {
+        for (auto& track : tracks) {
+            if (threadShouldExit()) {
+                return;
+            }
+            if (track.lengthInSeconds < 0) {
+                track.lengthInSeconds = decoders->getLengthInSeconds(track.file);
+            }
+        }
+        post(sequence, std::move(tracks));
+    });
+}
+
+bool PlaylistImporter::waitForRoom()
+{
+    for (;;) {
+        {
+            const ScopedLock sl(pendingLock);
+            if (nextSequence - nextToPost < maxBatchesInFlight) {
+                return true;
+            }
+        }
+        if (threadShouldExit()) {
+            return false;
+        }
+        wait(100);
+    }
+}
+
+void PlaylistImporter::post(int sequence, Array<Track> tracks)
+{
+    const ScopedLock sl(pendingLock);
+    finished[sequence] = std::move(tracks);
+    triggerAsyncUpdate();
+}
+
+void PlaylistImporter::handleAsyncUpdate()
+{
+    // Taking the batches that are next in the file, a batch still being opened holds back the ones after it
+    Array<Array<Track>> ready;
+    bool done = false;
+    int total = 0;
+    {
+        const ScopedLock sl(pendingLock);
+        for (auto next = finished.find(nextToPost); next != finished.end(); next = finished.find(nextToPost)) {
+            numImported += next->second.size();
+            ready.add(std::move(next->second));
+            finished.erase(next);
+            ++nextToPost;
+        }
+        done = numBatches >= 0 && nextToPost >= numBatches;
+        if (done) {
+            numBatches = -1;
+        }
+        total = numImported;
+    }
+    notify();
+
+    for (auto& tracks : ready) {
+        onTracks(tracks);
+    }
+    if (done) {
+        onFinished(playlist, total);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    PlaylistImporter.h
+    Created: 21 Oct 2026 10:12:37am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include "DecoderService.h"
+
+//==============================================================================
+/*
+    Imports playlists from other DJ software in the background: M3U and
+    M3U8 files, and collections in the rekordbox XML format.
+
+    The file is read in fixed size chunks and parsed as it streams in, so the
+    whole document is never held in memory. Entries are gathered into
+    batches, and the tracks in a batch whose length the playlist does not
+    give are opened on a thread pool. Only a few batches are in flight at
+    once, so memory stays bounded however big the collection is, and the
+    batches are handed to the callback on the message thread in the order
+    they appear in the file.
+*/
+class PlaylistImporter  : private Thread,
+                          private AsyncUpdater
+{
+public:
+    struct Track
+    {
+        File file;
+        double lengthInSeconds = -1;
+    };
+
+    PlaylistImporter(std::function<void(const Array<Track>&)> onTracksImported,
+                     std::function<void(const File&, int numImported)> onImportFinished);
+    ~PlaylistImporter() override;
+
+    /** true if the file is a playlist or collection this importer can read */
+    static bool canImport(const File& file);
+
+    /** start importing a playlist, stopping any import already running */
+    void startImport(const File& playlistFile);
+
+    /** stop the running import, the batches already handed over stay imported */
+    void cancel();
+
+    bool isImporting() const;
+
+private:
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    // Functions to stream each format, calling addTrack for every entry in order
+    bool readM3U(InputStream& stream, ThreadPool& pool);
+    bool readXml(InputStream& stream, ThreadPool& pool);
+
+    // Function to add an entry to the current batch, queueing the batch once it is full
+    void addTrack(const Track& track, ThreadPool& pool);
+
+    // Function to queue the current batch, opening the tracks without a length on the pool
+    void queueBatch(ThreadPool& pool);
+
+    // Function to wait until the message thread has taken enough batches, false if the import was stopped
+    bool waitForRoom();
+
+    // Function to hand a finished batch to the message thread
+    void post(int sequence, Array<Track> tracks);
+
+    // Tracks in a batch, and how many batches can be queued or waiting for the message thread at once
+    static constexpr int batchSize = 512;
+    static constexpr int maxBatchesInFlight = 16;
+
+    std::function<void(const Array<Track>&)> onTracks;
+    std::function<void(const File&, int)> onFinished;
+    SharedResourcePointer<DecoderService> decoders;
+
+    File playlist;
+
+    // Only used by the import thread
+    Array<Track> batch;
+    int nextSequence = 0;
+
+    // Finished batches by their place in the file, posted once every batch before them has been
+    CriticalSection pendingLock;
+    std::map<int, Array<Track>> finished;
+    int nextToPost = 0;
+    int numImported = 0;
+    int numBatches = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistImporter)
+};
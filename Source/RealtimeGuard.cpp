@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+    Created: 19 Oct 2026 7:14:33pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "RealtimeGuard.h"
+
+#if OTODECKS_REALTIME_GUARD
+
+#include <cstdlib>
+#include <new>
+#include <unordered_set>
+
+#if JUCE_LINUX
+ #include <atomic>
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <execinfo.h>
+#elif JUCE_WINDOWS
+ #include <windows.h>
+#endif
+
+//==============================================================================
+namespace
+{
+    // Plain thread locals, so reading them never allocates
+    thread_local int realtimeDepth = 0;
+    thread_local int suspendDepth = 0;
+
+    SpinLock& getReportedLock()
+    {
+        static SpinLock lock;
+        return lock;
+    }
+
+    // Never deleted, so allocations made while the application exits are still checked safely
+    std::unordered_set<int64>& getReportedStacks()
+    {
+        static auto* stacks = new std::unordered_set<int64>();
+        return *stacks;
+    }
+
+    // Function to hash the return addresses of the calling stack, which only walks the stack and never symbolizes
+    int64 hashCallStack()
+    {
+        constexpr int maxFrames = 64;
+        void* frames[maxFrames];
+       #if JUCE_LINUX || JUCE_MAC
+        const int numFrames = backtrace(frames, maxFrames);
+       #elif JUCE_WINDOWS
+        const int numFrames = (int) CaptureStackBackTrace(0, (DWORD) maxFrames, frames, nullptr);
+       #else
+        const int numFrames = 0;
+       #endif
+
+        uint64 hash = 14695981039346656037ull;
+        for (int i = 0; i < numFrames; ++i) {
+            hash = (hash ^ (uint64) (pointer_sized_uint) frames[i]) * 1099511628211ull;
+        }
+        return (int64) hash;
+    }
+
+    // Function to report a call that is not real-time safe, once for each call stack
+    void report(const char* what)
+    {
+        // The report allocates and locks as well, so the guard is suspended while it is made
+        RealtimeGuard::ScopedSuspend suspend;
+
+        // Stacks that were reported already are found from their raw addresses, as the same locks are taken in
+        // every callback and symbolizing each time would cause dropouts of its own
+        const int64 stackHash = hashCallStack();
+        {
+            const SpinLock::ScopedLockType sl(getReportedLock());
+            if (!getReportedStacks().insert(stackHash).second) {
+                return;
+            }
+        }
+
+        Logger::outputDebugString("Real-time violation: " + String(what) + " on the audio thread\n" + SystemStats::getStackBacktrace());
+    }
+
+    inline void check(const char* what)
+    {
+        if (realtimeDepth > 0 && suspendDepth == 0) {
+            report(what);
+        }
+    }
+
+    // Functions to allocate and free over-aligned blocks, which Windows keeps apart from malloc
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        const std::size_t bytes = size == 0 ? 1 : size;
+       #if JUCE_WINDOWS
+        return _aligned_malloc(bytes, (std::size_t) alignment);
+       #else
+        void* block = nullptr;
+        return posix_memalign(&block, jmax(sizeof(void*), (std::size_t) alignment), bytes) == 0 ? block : nullptr;
+       #endif
+    }
+
+    void freeAligned(void* block) noexcept
+    {
+       #if JUCE_WINDOWS
+        _aligned_free(block);
+       #else
+        std::free(block);
+       #endif
+    }
+}
+
+//==============================================================================
+RealtimeGuard::ScopedRealtime::ScopedRealtime() noexcept    { ++realtimeDepth; }
+RealtimeGuard::ScopedRealtime::~ScopedRealtime() noexcept   { --realtimeDepth; }
+
+RealtimeGuard::ScopedSuspend::ScopedSuspend() noexcept      { ++suspendDepth; }
+RealtimeGuard::ScopedSuspend::~ScopedSuspend() noexcept     { --suspendDepth; }
+
+//==============================================================================
+void* operator new(std::size_t size)
+{
+    check("operator new");
+    if (void* block = std::malloc(size == 0 ? 1 : size)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    check("operator new");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* block) noexcept
+{
+    if (block != nullptr) {
+        check("operator delete");
+    }
+    std::free(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+    operator delete(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept
+{
+    operator delete(block);
+}
+
+void operator delete[](void* block, std::size_t) noexcept
+{
+    operator delete(block);
+}
+
+// Over-aligned types, such as the SIMD registers juce_dsp works in, are allocated through these instead
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    check("operator new");
+    if (void* block = allocateAligned(size, alignment)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    check("operator new");
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept
+{
+    if (block != nullptr) {
+        check("operator delete");
+    }
+    freeAligned(block);
+}
+
+void operator delete[](void* block, std::align_val_t alignment) noexcept
+{
+    operator delete(block, alignment);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(block, alignment);
+}
+
+void operator delete[](void* block, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(block, alignment);
+}
+
+void operator delete(void* block, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    operator delete(block, alignment);
+}
+
+void operator delete[](void* block, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    operator delete(block, alignment);
+}
+
+#if JUCE_LINUX
+namespace
+{
+    using LockFunction = int (*)(pthread_mutex_t*);
+    std::atomic<LockFunction> libraryLock{ nullptr };
+}
+
+// Every CriticalSection and std::mutex ends up here, so locks taken in the callback are caught too
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    // Finding the C library's own lock function the first time, which it is then forwarded to
+    LockFunction lock = libraryLock.load(std::memory_order_acquire);
+    if (lock == nullptr) {
+        lock = (LockFunction) dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        libraryLock.store(lock, std::memory_order_release);
+    }
+
+    check("mutex lock");
+    return lock(mutex);
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+    Created: 19 Oct 2026 7:14:33pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// The guard is on in debug builds, and can be turned on or off with -DOTODECKS_REALTIME_GUARD=1 or 0
+#ifndef OTODECKS_REALTIME_GUARD
+ #if JUCE_DEBUG
+  #define OTODECKS_REALTIME_GUARD 1
+ #else
+  #define OTODECKS_REALTIME_GUARD 0
+ #endif
+#endif
+
+//==============================================================================
+/*
+    Catches code that is not real-time safe on the audio thread.
+
+    While a ScopedRealtime is alive on a thread, every operator new and
+    operator delete on that thread, and on Linux every pthread mutex lock, is
+    reported to the debug output with its call stack. Each call stack is only
+    reported once, so a violation in the callback does not flood the log.
+    Known, one-off work can be let through with a ScopedSuspend.
+
+    When the guard is off both classes are empty and cost nothing.
+*/
+class RealtimeGuard
+{
+public:
+    /** marks the calling thread as real-time, for the whole audio callback */
+    class ScopedRealtime
+    {
+    public:
+       #if OTODECKS_REALTIME_GUARD
+        ScopedRealtime() noexcept;
+        ~ScopedRealtime() noexcept;
+       #else
+        ScopedRealtime() noexcept {}
+       #endif
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (ScopedRealtime)
+    };
+
+    /** lets allocations and locks through on the calling thread without reporting them */
+    class ScopedSuspend
+    {
+    public:
+       #if OTODECKS_REALTIME_GUARD
+        ScopedSuspend() noexcept;
+        ~ScopedSuspend() noexcept;
+       #else
+        ScopedSuspend() noexcept {}
+       #endif
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (ScopedSuspend)
+    };
+
+private:
+    RealtimeGuard() = delete;
+};
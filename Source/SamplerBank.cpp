@@ -0,0 +1,303 @@
+/*
+  ==============================================================================
+
+    SamplerBank.cpp
+    Created: 20 Oct 2026 9:04:51pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SamplerBank.h"
+#include "Tracer.h"
+
+//==============================================================================
+SamplerBank::SamplerBank() : Thread("Sampler loader")
+{
+    for (int pad = 0; pad < numPads; ++pad) {
+        pending[pad] = nullptr;
+        retired[pad] = nullptr;
+        ready[pad] = false;
+        current[pad] = nullptr;
+    }
+    startThread(Thread::Priority::low);
+}
+
+SamplerBank::~SamplerBank()
+{
+    stopThread(4000);
+
+    // The audio has stopped by now, so every sample can be deleted here
+    for (int pad = 0; pad < numPads; ++pad) {
+        delete pending[pad].exchange(nullptr);
+        delete retired[pad].exchange(nullptr);
+        delete current[pad];
+    }
+}
+
+void SamplerBank::loadPad(int pad, const File& file)
+{
+    if (pad < 0 || pad >= numPads) {
+        return;
+    }
+
+    {
+        const ScopedLock sl(padLock);
+        padFiles[pad].file = file;
+        ++padFiles[pad].generation;
+    }
+    ready[pad] = false;
+    notify();
+}
+
+void SamplerBank::clearPad(int pad)
+{
+    loadPad(pad, File());
+}
+
+File SamplerBank::getPadFile(int pad) const
+{
+    if (pad < 0 || pad >= numPads) {
+        return {};
+    }
+
+    const ScopedLock sl(padLock);
+    return padFiles[pad].file;
+}
+
+bool SamplerBank::isPadReady(int pad) const
+{
+    return pad >= 0 && pad < numPads && ready[pad].load();
+}
+
+void SamplerBank::trigger(int pad, float gain)
+{
+    if (!isPadReady(pad)) {
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    triggerFifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 > 0) {
+        triggers[start1] = { pad, jlimit(0.0f, 1.0f, gain) };
+        triggerFifo.finishedWrite(1);
+    }
+}
+
+void SamplerBank::stopAll()
+{
+    int start1, size1, start2, size2;
+    triggerFifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 > 0) {
+        triggers[start1] = { -1, 0.0f };
+        triggerFifo.finishedWrite(1);
+    }
+}
+
+void SamplerBank::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // The loader converts the pads again if the output rate has changed
+    outputRate = sampleRate;
+    notify();
+}
+
+void SamplerBank::process(const AudioSourceChannelInfo& block)
+{
+    TraceSpan span("SamplerBank::process");
+
+    mixedLastBlock = false;
+
+    // Swapping in newly decoded samples, once the loader has deleted the last one this pad gave back
+    for (int pad = 0; pad < numPads; ++pad) {
+        if (retired[pad].load() != nullptr || pending[pad].load() == nullptr) {
+            continue;
+        }
+
+        Sample* sample = pending[pad].exchange(nullptr);
+        for (auto& voice : voices) {
+            if (voice.pad == pad && voice.sample != nullptr) {
+                fadeOutVoice(voice, block);
+            }
+        }
+
+        // The loader thread looks for samples to delete every time it wakes, it is not woken from here
+        retired[pad] = current[pad];
+        current[pad] = sample;
+    }
+
+    // Starting the pads triggered since the last block
+    const int numTriggers = triggerFifo.getNumReady();
+    if (numTriggers > 0) {
+        int start1, size1, start2, size2;
+        triggerFifo.prepareToRead(numTriggers, start1, size1, start2, size2);
+        for (int i = 0; i < size1 + size2; ++i) {
+            startVoice(triggers[i < size1 ? start1 + i : start2 + i - size1], block);
+        }
+        triggerFifo.finishedRead(size1 + size2);
+    }
+
+    for (auto& voice : voices) {
+        if (voice.sample != nullptr) {
+            mixVoice(voice, block, block.numSamples, voice.gain, voice.gain);
+        }
+    }
+}
+
+bool SamplerBank::isSilent() const
+{
+    return !mixedLastBlock;
+}
+
+void SamplerBank::startVoice(const Trigger& trigger, const AudioSourceChannelInfo& block)
+{
+    if (trigger.pad < 0) {
+        for (auto& voice : voices) {
+            if (voice.sample != nullptr) {
+                fadeOutVoice(voice, block);
+            }
+        }
+        return;
+    }
+
+    const Sample* sample = current[trigger.pad];
+    if (sample == nullptr || sample->buffer.getNumSamples() == 0) {
+        return;
+    }
+
+    // Taking a free voice, or the one that has been playing the longest
+    Voice* chosen = nullptr;
+    for (auto& voice : voices) {
+        if (voice.sample == nullptr) {
+            chosen = &voice;
+            break;
+        }
+        if (chosen == nullptr || voice.startedAt - chosen->startedAt > 0x80000000u) {
+            chosen = &voice;
+        }
+    }
+    if (chosen->sample != nullptr) {
+        fadeOutVoice(*chosen, block);
+    }
+
+    chosen->sample = sample;
+    chosen->pad = trigger.pad;
+    chosen->position = 0;
+    chosen->gain = trigger.gain;
+    chosen->startedAt = triggerCount++;
+}
+
+void SamplerBank::fadeOutVoice(Voice& voice, const AudioSourceChannelInfo& block)
+{
+    mixVoice(voice, block, jmin(fadeSamples, block.numSamples), voice.gain, 0.0f);
+    voice.sample = nullptr;
+    voice.pad = -1;
+}
+
+void SamplerBank::mixVoice(Voice& voice, const AudioSourceChannelInfo& block, int numSamples, float startGain, float endGain)
+{
+    const AudioBuffer<float>& source = voice.sample->buffer;
+    const int numToMix = jmin(numSamples, source.getNumSamples() - voice.position);
+
+    if (numToMix > 0) {
+        mixedLastBlock = true;
+
+        // The gain ramp is shortened with the mix so a voice that ends inside its fade still lands on the end gain
+        const float rampEnd = startGain + (endGain - startGain) * numToMix / (float) numSamples;
+        for (int channel = 0; channel < block.buffer->getNumChannels(); ++channel) {
+            const int sourceChannel = jmin(channel, source.getNumChannels() - 1);
+            block.buffer->addFromWithRamp(channel, block.startSample, source.getReadPointer(sourceChannel, voice.position),
+                                          numToMix, startGain, rampEnd);
+        }
+    }
+
+    voice.position += numToMix;
+    if (voice.position >= source.getNumSamples()) {
+        voice.sample = nullptr;
+        voice.pad = -1;
+    }
+}
+
+void SamplerBank::run()
+{
+    while (!threadShouldExit())
+    {
+        // Deleting the samples the audio thread has finished with
+        for (auto& sample : retired) {
+            delete sample.exchange(nullptr);
+        }
+
+        // Picking a pad whose file or output rate has changed since it was decoded
+        const double rate = outputRate.load();
+        int pad = -1;
+        File file;
+        int generation = 0;
+        if (rate > 0) {
+            const ScopedLock sl(padLock);
+            for (int i = 0; i < numPads && pad < 0; ++i) {
+                const bool rateChanged = padFiles[i].file != File() && padFiles[i].loadedRate != rate;
+                if (padFiles[i].loadedGeneration != padFiles[i].generation || rateChanged) {
+                    pad = i;
+                    file = padFiles[i].file;
+                    generation = padFiles[i].generation;
+                }
+            }
+        }
+
+        if (pad < 0) {
+            wait(50);
+            continue;
+        }
+
+        // An empty pad is handed over as an empty sample, so the audio thread lets go of the old one
+        Sample* sample = file == File() ? new Sample() : decode(file, rate);
+
+        {
+            const ScopedLock sl(padLock);
+            padFiles[pad].loadedGeneration = generation;
+            padFiles[pad].loadedRate = rate;
+
+            // The file was changed again while this one was decoding, so it is decoded again instead
+            if (padFiles[pad].generation != generation) {
+                delete sample;
+                continue;
+            }
+        }
+
+        if (sample == nullptr) {
+            DBG("Could not load " + file.getFullPathName() + " onto a pad");
+            sample = new Sample();
+        }
+        delete pending[pad].exchange(sample);
+        ready[pad] = sample->buffer.getNumSamples() > 0;
+    }
+}
+
+SamplerBank::Sample* SamplerBank::decode(const File& file, double rate)
+{
+    TraceSpan span("SamplerBank decode");
+
+    std::unique_ptr<AudioFormatReader> reader(decoders->createReaderFor(file, false));
+    if (reader == nullptr || reader->sampleRate <= 0 || reader->lengthInSamples <= 0) {
+        return nullptr;
+    }
+
+    const int numChannels = jlimit(1, 2, (int) reader->numChannels);
+    const int numSourceSamples = (int) jmin(reader->lengthInSamples, (int64) (maxSampleSeconds * reader->sampleRate));
+    AudioBuffer<float> decoded(numChannels, numSourceSamples + 8);
+    decoded.clear();
+    reader->read(&decoded, 0, numSourceSamples, 0, true, numChannels > 1);
+
+    // Converting to the output rate once here, so the voices only have to copy
+    std::unique_ptr<Sample> sample(new Sample());
+    sample->sampleRate = rate;
+    const double ratio = reader->sampleRate / rate;
+    const int numSamples = (int) (numSourceSamples / ratio);
+    sample->buffer.setSize(numChannels, numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        LagrangeInterpolator interpolator;
+        interpolator.process(ratio, decoded.getReadPointer(channel), sample->buffer.getWritePointer(channel), numSamples);
+    }
+    return sample.release();
+}
@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    SamplerBank.h
+    Created: 20 Oct 2026 9:04:51pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "DecoderService.h"
+
+//==============================================================================
+/*
+    A bank of pads that fire one-shots over the decks.
+
+    Each pad's sample is decoded in full on a background thread and converted
+    to the output sample rate, so playing it never touches the disk. The
+    audio thread mixes the pads into the master from a fixed pool of voices
+    in the same callback as the decks. Triggers reach it through a lock-free
+    FIFO, and when every voice is busy the oldest one is faded out and
+    reused, so a trigger never allocates or locks.
+
+    New samples are handed to the audio thread through an atomic pointer for
+    each pad. The audio thread swaps them in at the start of a block and
+    hands the old sample back to the loader thread, which deletes it the next
+    time it wakes.
+*/
+class SamplerBank  : private Thread
+{
+public:
+    static constexpr int numPads = 8;
+    static constexpr int numVoices = 16;
+
+    SamplerBank();
+    ~SamplerBank() override;
+
+    /** decode a file onto a pad in the background, replacing what was on it */
+    void loadPad(int pad, const File& file);
+    void clearPad(int pad);
+
+    /** get the file on a pad, which may still be decoding */
+    File getPadFile(int pad) const;
+
+    /** true once a pad's sample has been decoded and can be played */
+    bool isPadReady(int pad) const;
+
+    /** play a pad from the start of the next audio block, called on the message thread */
+    void trigger(int pad, float gain = 1.0f);
+
+    /** fade out every playing voice, called on the message thread */
+    void stopAll();
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /** mix the playing voices into a block, called on the audio thread */
+    void process(const AudioSourceChannelInfo& block);
+
+    /** true when no voice was mixed into the last block processed, called on the audio thread */
+    bool isSilent() const;
+
+private:
+    void run() override;
+
+    // A decoded sample at the output sample rate
+    struct Sample
+    {
+        AudioBuffer<float> buffer;
+        double sampleRate = 0;
+    };
+
+    // One playing sample, only touched by the audio thread
+    struct Voice
+    {
+        const Sample* sample = nullptr;
+        int pad = -1;
+        int position = 0;
+        float gain = 1.0f;
+        uint32 startedAt = 0;
+    };
+
+    // A trigger from the message thread, pad -1 stops every voice
+    struct Trigger
+    {
+        int pad = -1;
+        float gain = 1.0f;
+    };
+
+    // Function to decode a file and convert it to the output rate, nullptr if it cannot be read
+    Sample* decode(const File& file, double outputRate);
+
+    // Function to start a pad on a free voice, or on the oldest one when they are all playing
+    void startVoice(const Trigger& trigger, const AudioSourceChannelInfo& block);
+
+    // Function to fade a voice out over the start of the block and free it, used when it is stolen or replaced
+    void fadeOutVoice(Voice& voice, const AudioSourceChannelInfo& block);
+
+    // Function to add the next samples of a voice into the block, with a gain ramp when the ends differ
+    void mixVoice(Voice& voice, const AudioSourceChannelInfo& block, int numSamples, float startGain, float endGain);
+
+    // Longest sample a pad takes, anything longer is cut
+    static constexpr double maxSampleSeconds = 30.0;
+
+    // Length of the fade when a voice is stolen or its pad is replaced
+    static constexpr int fadeSamples = 128;
+
+    static constexpr int triggerFifoSize = 256;
+
+    SharedResourcePointer<DecoderService> decoders;
+
+    // The file wanted on each pad, shared by the message thread and the loader thread
+    struct PadFile
+    {
+        File file;
+        int generation = 0;
+        int loadedGeneration = 0;
+        double loadedRate = 0;
+    };
+    CriticalSection padLock;
+    PadFile padFiles[numPads];
+
+    // Handed from the loader thread to the audio thread, and back once the audio thread stops using them
+    std::atomic<Sample*> pending[numPads];
+    std::atomic<Sample*> retired[numPads];
+    std::atomic<bool> ready[numPads];
+    std::atomic<double> outputRate{ 0 };
+
+    AbstractFifo triggerFifo{ triggerFifoSize };
+    Trigger triggers[triggerFifoSize];
+
+    // Only touched by the audio thread
+    Sample* current[numPads];
+    Voice voices[numVoices];
+    uint32 triggerCount = 0;
+    bool mixedLastBlock = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplerBank)
+};
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    SamplerComponent.cpp
+    Created: 20 Oct 2026 9:41:26pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <fstream>
+#include "SamplerComponent.h"
+
+//==============================================================================
+SamplerComponent::SamplerComponent(SamplerBank& bankToUse) : bank(bankToUse)
+{
+    for (int i = 0; i < SamplerBank::numPads; ++i) {
+        auto* padButton = padButtons.add(new TextButton());
+
+        // Pads fire as soon as they are pressed, not when the mouse is let go
+        padButton->setTriggeredOnMouseDown(true);
+        padButton->onClick = [this, i] { padPressed(i); };
+        addAndMakeVisible(padButton);
+    }
+
+    loadPads();
+    updatePads();
+    startTimer(250);
+}
+
+SamplerComponent::~SamplerComponent()
+{
+    stopTimer();
+}
+
+void SamplerComponent::paint(Graphics& g)
+{
+    g.fillAll(Colours::black);
+
+    g.setColour(Colours::red);
+    g.drawRect(getLocalBounds(), 1);
+}
+
+void SamplerComponent::resized()
+{
+    double padW = (double) (getWidth() - 4) / padButtons.size();
+    for (int i = 0; i < padButtons.size(); ++i) {
+        padButtons[i]->setBounds(2 + padW * i + 2, 4, padW - 4, getHeight() - 8);
+    }
+}
+
+bool SamplerComponent::isInterestedInFileDrag(const StringArray& files)
+{
+    return files.size() == 1;
+}
+
+void SamplerComponent::filesDropped(const StringArray& files, int x, int y)
+{
+    for (int i = 0; i < padButtons.size(); ++i) {
+        if (padButtons[i]->getBounds().contains(x, y)) {
+            loadPad(i, File(files[0]));
+        }
+    }
+}
+
+void SamplerComponent::timerCallback()
+{
+    // Pads turn orange once their sample has been decoded
+    updatePads();
+}
+
+void SamplerComponent::padPressed(int pad)
+{
+    if (ModifierKeys::getCurrentModifiers().isShiftDown()) {
+        loadPad(pad, File());
+    }
+    else if (bank.getPadFile(pad) != File()) {
+        bank.trigger(pad);
+        if (onPadTriggered) {
+            onPadTriggered();
+        }
+    }
+    else {
+        auto fileChooserFlags = FileBrowserComponent::canSelectFiles;
+        fChooser.launchAsync(fileChooserFlags, [this, pad](const FileChooser& chooser) {
+            if (chooser.getResult() != File()) {
+                loadPad(pad, chooser.getResult());
+            }
+        });
+    }
+}
+
+void SamplerComponent::loadPad(int pad, const File& file)
+{
+    bank.loadPad(pad, file);
+    savePads();
+    updatePads();
+}
+
+void SamplerComponent::updatePads()
+{
+    for (int i = 0; i < padButtons.size(); ++i) {
+        const File file = bank.getPadFile(i);
+        const Colour colour = bank.isPadReady(i) ? Colours::orange : Colours::darkgrey;
+        if (padButtons[i]->findColour(TextButton::buttonColourId) != colour) {
+            padButtons[i]->setColour(TextButton::buttonColourId, colour);
+        }
+
+        padButtons[i]->setButtonText(file != File() ? file.getFileNameWithoutExtension() : String(i + 1));
+        padButtons[i]->setTooltip(file != File() ? file.getFullPathName() + ", shift-click to clear"
+                                                 : "Click to load a sample onto pad " + String(i + 1));
+    }
+}
+
+void SamplerComponent::loadPads()
+{
+    // Each line is "pad <tab> path"
+    std::ifstream file("SamplerPads.txt");
+    std::string line;
+    while (std::getline(file, line)) {
+        StringArray fields = StringArray::fromTokens(String(line), "\t", "");
+        if (fields.size() != 2) {
+            continue;
+        }
+
+        const File sample(fields[1]);
+        if (sample.existsAsFile()) {
+            bank.loadPad(fields[0].getIntValue(), sample);
+        }
+    }
+}
+
+void SamplerComponent::savePads() const
+{
+    // Writing to SamplerPads.txt
+    std::ofstream file("SamplerPads.txt");
+    for (int i = 0; i < SamplerBank::numPads; ++i) {
+        const File sample = bank.getPadFile(i);
+        if (sample != File()) {
+            file << i << "\t" << sample.getFullPathName() << std::endl;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    SamplerComponent.h
+    Created: 20 Oct 2026 9:41:26pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SamplerBank.h"
+
+//==============================================================================
+/*
+    The pads of the sampler bank. Clicking an empty pad, or dropping a file
+    on any pad, loads a sample onto it, clicking a loaded pad fires it and
+    shift-click clears it. The pads are saved in SamplerPads.txt.
+*/
+class SamplerComponent  : public Component,
+                          public FileDragAndDropTarget,
+                          private Timer
+{
+public:
+    SamplerComponent(SamplerBank& bankToUse);
+    ~SamplerComponent() override;
+
+    void paint(Graphics&) override;
+    void resized() override;
+
+    bool isInterestedInFileDrag(const StringArray& files) override;
+    void filesDropped(const StringArray& files, int x, int y) override;
+
+    /** called on the message thread when a pad is fired, so the master meters can wake up */
+    std::function<void()> onPadTriggered;
+
+private:
+    void timerCallback() override;
+
+    // Function to fire a pad, load a sample onto it when it is empty, or clear it with shift held
+    void padPressed(int pad);
+
+    // Function to load a file onto a pad and save the pads
+    void loadPad(int pad, const File& file);
+
+    // Function to update the colour and name of each pad
+    void updatePads();
+
+    void loadPads();
+    void savePads() const;
+
+    SamplerBank& bank;
+    OwnedArray<TextButton> padButtons;
+
+    FileChooser fChooser{ "Select a sample...", File(), "*.wav;*.aiff;*.flac;*.mp3;*.ogg", true, false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplerComponent)
+};
@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+    ScrubEngine.cpp
+    Created: 19 Oct 2026 11:21:02am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ScrubEngine.h"
+
+//==============================================================================
+namespace
+{
+    // Time taken for the playhead to catch up with the slider
+    const double catchUpSeconds = 0.05;
+
+    // Time taken for the rate to follow a change of slider speed, like the mass of a platter
+    const double inertiaSeconds = 0.02;
+
+    // Fastest scrub rate as a multiple of normal speed
+    const double maxRateMultiple = 8.0;
+}
+
+//==============================================================================
+ScrubEngine::ScrubEngine() : Thread("Scrub window")
+{
+    for (int i = 0; i < 2; ++i) {
+        windows[i].setSize(2, windowSize);
+        windows[i].clear();
+        windowStart[i] = -1;
+    }
+
+    startThread(Thread::Priority::high);
+}
+
+ScrubEngine::~ScrubEngine()
+{
+    stopThread(2000);
+}
+
+void ScrubEngine::setReader(AudioFormatReader* newReader)
+{
+    sourceSampleRate = newReader != nullptr ? newReader->sampleRate : 0.0;
+    sourceLength = newReader != nullptr ? newReader->lengthInSamples : 0;
+
+    // The reader is only handed over here, the background thread adopts it before it fills the next window.
+    // A reader that was never adopted is deleted outside the lock
+    std::unique_ptr<AudioFormatReader> unused(newReader);
+    {
+        const ScopedLock sl(readerLock);
+        std::swap(pendingReader, unused);
+        readerPending = true;
+    }
+
+    // The windows belong to the old track
+    windowStart[0] = -1;
+    windowStart[1] = -1;
+    requestedCentre = -1;
+    notify();
+}
+
+bool ScrubEngine::canScrub() const
+{
+    return sourceSampleRate.load() > 0;
+}
+
+void ScrubEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    outputSampleRate = sampleRate;
+}
+
+void ScrubEngine::begin(double posInSecs)
+{
+    const double start = posInSecs * sourceSampleRate.load();
+    targetPosition = start;
+    pendingStart = start;
+
+    // The audio thread is not playing from a window yet, so any window can be filled
+    windowInUse = activeWindow.load();
+    requestWindow((int64) start);
+}
+
+void ScrubEngine::end()
+{
+    requestedCentre = -1;
+}
+
+void ScrubEngine::setTargetPosition(double posInSecs)
+{
+    targetPosition = jlimit(0.0, (double) sourceLength.load(), posInSecs * sourceSampleRate.load());
+}
+
+double ScrubEngine::getPlayheadPosition() const
+{
+    const double sampleRate = sourceSampleRate.load();
+    return sampleRate > 0 ? publishedPlayhead.load() / sampleRate : 0.0;
+}
+
+void ScrubEngine::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const double start = pendingStart.exchange(-1.0);
+    if (start >= 0) {
+        playhead = start;
+        rate = 0;
+    }
+
+    // Taking the newest window and telling the background thread which one is being read
+    const int w = activeWindow.load();
+    windowInUse = w;
+    const int64 wStart = windowStart[w].load();
+
+    const double length = (double) sourceLength.load();
+    const double target = targetPosition.load();
+    const double baseRate = sourceSampleRate.load() / outputSampleRate;
+    const double maxRate = baseRate * maxRateMultiple;
+    const double pull = 1.0 / (catchUpSeconds * outputSampleRate);
+    const double inertia = 1.0 - std::exp(-1.0 / (inertiaSeconds * outputSampleRate));
+
+    // A jump further than the window can cover moves the playhead straight to the slider
+    if (std::abs(target - playhead) > windowSize / 2) {
+        playhead = target;
+        rate = 0;
+    }
+
+    auto* buffer = bufferToFill.buffer;
+    const int numOutputChannels = jmin(buffer->getNumChannels(), 2);
+
+    for (int i = 0; i < bufferToFill.numSamples; ++i)
+    {
+        // The rate follows the speed needed to reach the slider, with some inertia
+        const double desired = jlimit(-maxRate, maxRate, (target - playhead) * pull);
+        rate += (desired - rate) * inertia;
+        playhead = jlimit(0.0, length, playhead + rate);
+
+        // Fading out as the platter slows down so a still slider is silent
+        const float gain = baseRate > 0 ? (float) jmin(1.0, std::abs(rate) / baseRate * 4.0) : 0.0f;
+        const double index = playhead - (double) wStart;
+        const bool inWindow = wStart >= 0 && index >= 1.0 && index < windowSize - 3;
+
+        for (int channel = 0; channel < numOutputChannels; ++channel) {
+            const float sample = inWindow ? interpolate(windows[w].getReadPointer(channel), index) : 0.0f;
+            buffer->setSample(channel, bufferToFill.startSample + i, sample * gain);
+        }
+    }
+
+    for (int channel = numOutputChannels; channel < buffer->getNumChannels(); ++channel) {
+        buffer->clear(channel, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+
+    publishedPlayhead = playhead;
+
+    // Asking for a new window when the playhead gets near either end of the current one
+    const bool nearStart = wStart > 0 && playhead < wStart + refillMargin;
+    const bool nearEnd = wStart + windowSize < sourceLength.load() && playhead > wStart + windowSize - refillMargin;
+    if (wStart < 0 || nearStart || nearEnd || playhead < wStart || playhead >= wStart + windowSize) {
+        requestWindow((int64) playhead);
+    }
+}
+
+void ScrubEngine::requestWindow(int64 centre)
+{
+    // Only waking the thread when the window it is working towards is far from the playhead
+    const int64 current = requestedCentre.load();
+    if (current >= 0 && std::abs(current - centre) < refillMargin / 2) {
+        return;
+    }
+
+    requestedCentre = centre;
+    notify();
+}
+
+float ScrubEngine::interpolate(const float* data, double index)
+{
+    const int i = (int) index;
+    const float t = (float) (index - i);
+
+    const float y0 = data[i - 1];
+    const float y1 = data[i];
+    const float y2 = data[i + 1];
+    const float y3 = data[i + 2];
+
+    // Catmull-Rom spline through the four samples around the index
+    const float c1 = 0.5f * (y2 - y0);
+    const float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+    const float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+    return ((c3 * t + c2) * t + c1) * t + y1;
+}
+
+void ScrubEngine::run()
+{
+    while (!threadShouldExit())
+    {
+        // Adopting a new reader between windows, the old one is deleted once the lock has been let go
+        if (readerPending.load()) {
+            std::unique_ptr<AudioFormatReader> oldReader;
+            {
+                const ScopedLock sl(readerLock);
+                oldReader = std::move(reader);
+                reader = std::move(pendingReader);
+                readerPending = false;
+            }
+        }
+
+        const int64 centre = requestedCentre.load();
+        if (centre < 0) {
+            wait(-1);
+            continue;
+        }
+
+        // The audio thread must have moved to the newest window before the other one is overwritten
+        const int active = activeWindow.load();
+        if (windowInUse.load() != active) {
+            wait(2);
+            continue;
+        }
+
+        const int fill = 1 - active;
+        const int64 start = jlimit((int64) 0, jmax((int64) 0, sourceLength.load() - windowSize),
+                                   centre - windowSize / 2);
+
+        if (windowStart[active].load() != start) {
+            if (reader == nullptr) {
+                requestedCentre = -1;
+                continue;
+            }
+
+            windows[fill].clear();
+            reader->read(&windows[fill], 0, windowSize, start, true, true);
+
+            // A window read from the old track is not published once a new one has been given
+            if (readerPending.load()) {
+                continue;
+            }
+            windowStart[fill] = start;
+            activeWindow = fill;
+        }
+
+        // A newer request may have come in while this window was being filled
+        int64 expected = centre;
+        requestedCentre.compare_exchange_strong(expected, -1);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    ScrubEngine.h
+    Created: 19 Oct 2026 11:21:02am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Vinyl style scrubbing for a deck.
+
+    While scrubbing, the playhead is pulled towards the position of the
+    position slider with some inertia, so the playback rate follows how fast
+    the slider moves, forwards or backwards. Audio is read with interpolation
+    from a window of decoded samples around the playhead. The window is
+    refilled by a background thread using the engine's own reader, so the
+    audio thread never seeks the decoder and does the same work every block.
+*/
+class ScrubEngine  : private Thread
+{
+public:
+    ScrubEngine();
+    ~ScrubEngine() override;
+
+    /** give the engine its own reader for the loaded track, the engine takes ownership */
+    void setReader(AudioFormatReader* newReader);
+
+    /** true when a reader has been given so the loaded track can be scrubbed */
+    bool canScrub() const;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    /** start scrubbing from a position in seconds */
+    void begin(double posInSecs);
+
+    /** stop scrubbing and let the background thread rest */
+    void end();
+
+    /** move the position in seconds that the playhead is pulled towards */
+    void setTargetPosition(double posInSecs);
+
+    /** get where the playhead has got to in seconds */
+    double getPlayheadPosition() const;
+
+    /** fill the buffer by playing the window around the playhead at the scrub rate */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill);
+
+private:
+    void run() override;
+
+    // Function to ask the background thread for a window centred on a sample
+    void requestWindow(int64 centre);
+
+    // Function to read one sample from a window with cubic interpolation
+    static float interpolate(const float* data, double index);
+
+    // Length of each window of decoded audio in samples
+    static constexpr int windowSize = 1 << 18;
+
+    // The window is refilled when the playhead gets this close to either end
+    static constexpr int refillMargin = windowSize / 4;
+
+    // A new reader waits here until the background thread adopts it between windows, the lock is only held to swap
+    CriticalSection readerLock;
+    std::unique_ptr<AudioFormatReader> pendingReader;
+    std::atomic<bool> readerPending{ false };
+
+    // Only used by the background thread, which never decodes while holding the lock
+    std::unique_ptr<AudioFormatReader> reader;
+    std::atomic<double> sourceSampleRate{ 0 };
+    std::atomic<int64> sourceLength{ 0 };
+    double outputSampleRate = 44100;
+
+    // Two windows, the audio thread plays from one while the other is filled
+    AudioBuffer<float> windows[2];
+    std::atomic<int64> windowStart[2];
+    std::atomic<int> activeWindow{ 0 };
+    std::atomic<int> windowInUse{ 0 };
+    std::atomic<int64> requestedCentre{ -1 };
+
+    // Written by the message thread, read by the audio thread
+    std::atomic<double> targetPosition{ 0 };
+    std::atomic<double> pendingStart{ -1 };
+
+    // Only touched by the audio thread, apart from the published playhead
+    double playhead = 0;
+    double rate = 0;
+    std::atomic<double> publishedPlayhead{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScrubEngine)
+};
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    Tracer.cpp
+    Created: 19 Oct 2026 6:25:10pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Tracer.h"
+#include "RealtimeGuard.h"
+#include <atomic>
+
+//==============================================================================
+namespace
+{
+    // Each thread keeps its newest 32768 spans
+    const int eventsPerThread = 1 << 15;
+
+    struct Event
+    {
+        const char* name;
+        int64 startTicks;
+        int64 endTicks;
+    };
+
+    // The ring of one thread, only written by that thread
+    struct ThreadBuffer
+    {
+        int threadIndex = 0;
+        String threadName;
+        std::unique_ptr<Event[]> events{ new Event[eventsPerThread] };
+        std::atomic<uint64> written{ 0 };
+    };
+
+    std::atomic<bool> tracingEnabled{ false };
+
+    // The rings are kept until the application exits, so spans from threads that have finished are still written
+    CriticalSection& getRegistryLock()
+    {
+        static CriticalSection lock;
+        return lock;
+    }
+
+    OwnedArray<ThreadBuffer>& getRegistry()
+    {
+        static auto* registry = new OwnedArray<ThreadBuffer>();
+        return *registry;
+    }
+
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+
+    // The ring made ahead for the audio thread, and whether the audio thread has taken one since the device was prepared
+    std::atomic<ThreadBuffer*> reservedBuffer{ nullptr };
+    std::atomic<bool> realtimeThreadPrepared{ false };
+    std::atomic<bool> realtimeBufferClaimed{ false };
+
+    // Function to make a ring and add it to the registry
+    ThreadBuffer* createThreadBuffer(const String& threadName)
+    {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->threadName = threadName;
+
+        const ScopedLock sl(getRegistryLock());
+        buffer->threadIndex = getRegistry().size() + 1;
+        return getRegistry().add(buffer.release());
+    }
+
+    // Function to make the audio thread's ring while tracing is on and it does not have one yet
+    void reserveRealtimeBuffer()
+    {
+        if (tracingEnabled && realtimeThreadPrepared && !realtimeBufferClaimed && reservedBuffer.load() == nullptr) {
+            ThreadBuffer* expected = nullptr;
+            auto* buffer = createThreadBuffer("Audio thread");
+
+            // When another thread reserved one first, this one stays in the registry empty and is never written
+            reservedBuffer.compare_exchange_strong(expected, buffer);
+        }
+    }
+
+    // Function to find the calling thread's ring, creating it the first time
+    ThreadBuffer* getThreadBuffer()
+    {
+        if (threadBuffer == nullptr) {
+            // The audio thread has normally taken its reserved ring, so this only allocates there if it raced the reservation
+            RealtimeGuard::ScopedSuspend suspend;
+
+            String threadName;
+            if (auto* thread = Thread::getCurrentThread()) {
+                threadName = thread->getThreadName();
+            }
+            else if (MessageManager::getInstanceWithoutCreating() != nullptr
+                     && MessageManager::getInstanceWithoutCreating()->isThisTheMessageThread()) {
+                threadName = "Message thread";
+            }
+            else {
+                threadName = "Thread " + String::toHexString((pointer_sized_int) Thread::getCurrentThreadId());
+            }
+
+            threadBuffer = createThreadBuffer(threadName);
+        }
+        return threadBuffer;
+    }
+}
+
+//==============================================================================
+void Tracer::setEnabled(bool shouldBeEnabled)
+{
+    tracingEnabled = shouldBeEnabled;
+    reserveRealtimeBuffer();
+}
+
+void Tracer::prepareRealtimeThread()
+{
+    // The device may call back on a new thread after it is prepared again, and that thread gets a new ring
+    realtimeThreadPrepared = true;
+    realtimeBufferClaimed = false;
+    reserveRealtimeBuffer();
+}
+
+void Tracer::claimRealtimeBuffer() noexcept
+{
+    if (threadBuffer == nullptr) {
+        if (auto* buffer = reservedBuffer.exchange(nullptr)) {
+            threadBuffer = buffer;
+            realtimeBufferClaimed = true;
+        }
+    }
+}
+
+bool Tracer::isEnabled() noexcept
+{
+    return tracingEnabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::record(const char* name, int64 startTicks, int64 endTicks) noexcept
+{
+    auto* buffer = getThreadBuffer();
+    const uint64 index = buffer->written.load(std::memory_order_relaxed);
+
+    buffer->events[index % eventsPerThread] = { name, startTicks, endTicks };
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::writeTo(const File& file)
+{
+    const double ticksToMicros = 1.0e6 / (double) Time::getHighResolutionTicksPerSecond();
+
+    MemoryOutputStream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    const ScopedLock sl(getRegistryLock());
+    for (auto* buffer : getRegistry())
+    {
+        // Skipping the ring reserved for an audio thread that never ran
+        if (buffer->written.load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+
+        if (!first) {
+            json << ",";
+        }
+        first = false;
+        json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIndex
+             << ",\"args\":{\"name\":" << JSON::toString(buffer->threadName) << "}}";
+
+        // Copying the ring, then dropping any event the thread may have overwritten while it was copied
+        const uint64 end = buffer->written.load(std::memory_order_acquire);
+        const uint64 begin = end > (uint64) eventsPerThread ? end - eventsPerThread : 0;
+        std::vector<Event> events;
+        events.reserve((size_t) (end - begin));
+        for (uint64 i = begin; i < end; ++i) {
+            events.push_back(buffer->events[i % eventsPerThread]);
+        }
+
+        const uint64 after = buffer->written.load(std::memory_order_acquire);
+        const uint64 firstSafe = after > (uint64) eventsPerThread ? after - eventsPerThread : 0;
+
+        for (uint64 i = jmax(begin, firstSafe); i < end; ++i) {
+            const auto& event = events[(size_t) (i - begin)];
+            json << ",{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex
+                 << ",\"ts\":" << String(event.startTicks * ticksToMicros, 3)
+                 << ",\"dur\":" << String((event.endTicks - event.startTicks) * ticksToMicros, 3) << "}";
+        }
+    }
+    json << "]}";
+
+    return file.replaceWithData(json.getData(), json.getDataSize());
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    Tracer.h
+    Created: 19 Oct 2026 6:25:10pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Records timed spans from any thread and writes them out as Chrome trace
+    event JSON, which can be opened in chrome://tracing or ui.perfetto.dev.
+
+    Each thread writes into its own fixed size ring of events without locking,
+    so spans can be recorded on the audio thread. A thread's ring is created
+    the first time it records a span while tracing is on, and when it is full
+    the oldest events are overwritten. The audio thread's ring is made ahead
+    on the thread that prepares the device, or when tracing is turned on, and
+    the audio thread takes it without allocating or locking. When tracing is
+    off a span only reads one flag.
+*/
+class Tracer
+{
+public:
+    static void setEnabled(bool shouldBeEnabled);
+    static bool isEnabled() noexcept;
+
+    /** make a ring ready for the audio thread, called when the device is prepared */
+    static void prepareRealtimeThread();
+
+    /** give the calling thread the ring made ready for it, called at the start of every audio callback */
+    static void claimRealtimeBuffer() noexcept;
+
+    /** write every span recorded so far to a trace file */
+    static bool writeTo(const File& file);
+
+    /** add a finished span to the calling thread's ring, the name must be a string literal */
+    static void record(const char* name, int64 startTicks, int64 endTicks) noexcept;
+
+private:
+    Tracer() = delete;
+};
+
+//==============================================================================
+/*
+    Records a span from its construction to its destruction.
+*/
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char* spanName) noexcept
+        : name(spanName), startTicks(Tracer::isEnabled() ? Time::getHighResolutionTicks() : 0)
+    {
+    }
+
+    ~TraceSpan() noexcept
+    {
+        if (startTicks != 0) {
+            Tracer::record(name, startTicks, Time::getHighResolutionTicks());
+        }
+    }
+
+private:
+    const char* name;
+    int64 startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE (TraceSpan)
+};
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    TrackPreloader.cpp
+    Created: 19 Oct 2026 9:12:40am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "TrackPreloader.h"
+#include "Tracer.h"
+
+//==============================================================================
+TrackPreloader::TrackPreloader(AudioFormatManager& formatManagerToUse,
+                               AudioThumbnailCache& cacheToUse)
+                               : Thread("Track preloader"),
+                                 formatManager(formatManagerToUse),
+                                 thumbCache(cacheToUse)
+{
+    startThread(Thread::Priority::low);
+}
+
+TrackPreloader::~TrackPreloader()
+{
+    stopThread(2000);
+}
+
+void TrackPreloader::preload(const Array<File>& tracks)
+{
+    {
+        const ScopedLock sl(entryLock);
+
+        // Dropping the tracks that are no longer wanted
+        for (int i = entries.size(); --i >= 0;) {
+            if (!tracks.contains(entries[i]->file)) {
+                entries.remove(i);
+            }
+        }
+
+        // Adding the new tracks and starting their thumbnails
+        for (auto& track : tracks) {
+            if (!track.existsAsFile() || findEntry(track) != nullptr) {
+                continue;
+            }
+
+            auto* entry = entries.add(new Entry());
+            entry->file = track;
+
+            // The thumbnail uses the same source as WaveformDisplay so that the finished
+            // thumbnail is found in the cache when the track is loaded on a deck
+            entry->thumbnail = std::make_unique<AudioThumbnail>(1000, formatManager, thumbCache);
+            entry->thumbnail->setSource(new URLInputSource(URL{ track }));
+        }
+    }
+
+    notify();
+}
+
+std::unique_ptr<AudioFormatReader> TrackPreloader::takeReader(const File& track)
+{
+    const ScopedLock sl(entryLock);
+
+    auto* entry = findEntry(track);
+    if (entry == nullptr || entry->state != Entry::ready) {
+        return nullptr;
+    }
+
+    // The thumbnail is kept so that it can finish building into the cache
+    entry->state = Entry::finished;
+    return std::move(entry->reader);
+}
+
+TrackPreloader::Entry* TrackPreloader::findEntry(const File& track)
+{
+    for (auto* entry : entries) {
+        if (entry->file == track) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+void TrackPreloader::run()
+{
+    AudioBuffer<float> scratch;
+
+    while (!threadShouldExit())
+    {
+        File track;
+
+        // Picking the next track that has not been decoded yet
+        {
+            const ScopedLock sl(entryLock);
+            for (auto* entry : entries) {
+                if (entry->state == Entry::waiting) {
+                    entry->state = Entry::decoding;
+                    track = entry->file;
+                    break;
+                }
+            }
+        }
+
+        if (track == File()) {
+            wait(-1);
+            continue;
+        }
+
+        TraceSpan span("TrackPreloader decode");
+
+        // Opening the track also builds its mp3 seek index the first time it is seen
+        std::unique_ptr<AudioFormatReader> reader(decoders->createReaderFor(track));
+
+        if (reader != nullptr) {
+            // Decoding the start of the track so the decoder and the disk cache are warm
+            const int blockSize = 8192;
+            const int64 samplesToDecode = jmin(reader->lengthInSamples,
+                                               (int64) (reader->sampleRate * preDecodeSeconds));
+            scratch.setSize((int) reader->numChannels, blockSize, false, false, true);
+
+            for (int64 pos = 0; pos < samplesToDecode && !threadShouldExit(); pos += blockSize) {
+                const int numSamples = (int) jmin((int64) blockSize, samplesToDecode - pos);
+                reader->read(&scratch, 0, numSamples, pos, true, true);
+            }
+        }
+
+        const ScopedLock sl(entryLock);
+
+        // The track may have been dropped while it was being decoded
+        if (auto* entry = findEntry(track)) {
+            entry->state = reader != nullptr ? Entry::ready : Entry::finished;
+            entry->reader = std::move(reader);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    TrackPreloader.h
+    Created: 19 Oct 2026 9:12:40am
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DecoderService.h"
+
+//==============================================================================
+/*
+    Warms up tracks in the background before they are added to a deck.
+
+    For every track it is given, the preloader opens a reader and decodes the
+    first few seconds on a low priority thread, and builds the waveform
+    thumbnail into the shared thumbnail cache. When the track is then added to
+    a deck, the opened reader is handed over and the waveform comes straight
+    out of the cache.
+*/
+class TrackPreloader  : private Thread
+{
+public:
+    TrackPreloader(AudioFormatManager& formatManagerToUse,
+                   AudioThumbnailCache& cacheToUse);
+    ~TrackPreloader() override;
+
+    /** start warming up the given tracks, dropping any other tracks that are not in the list */
+    void preload(const Array<File>& tracks);
+
+    /** hand over the opened reader of a track, or nullptr if its warm-up has not finished */
+    std::unique_ptr<AudioFormatReader> takeReader(const File& track);
+
+private:
+    void run() override;
+
+    // State kept for each track that is being warmed up
+    struct Entry
+    {
+        File file;
+        std::unique_ptr<AudioFormatReader> reader;
+        std::unique_ptr<AudioThumbnail> thumbnail;
+        enum State { waiting, decoding, ready, finished } state = waiting;
+    };
+
+    Entry* findEntry(const File& track);
+
+    // Seconds of audio decoded ahead for each track
+    static constexpr double preDecodeSeconds = 5.0;
+
+    AudioFormatManager& formatManager;
+    AudioThumbnailCache& thumbCache;
+    SharedResourcePointer<DecoderService> decoders;
+
+    CriticalSection entryLock;
+    OwnedArray<Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackPreloader)
+};
@@ -0,0 +1,303 @@
+/*
+  ==============================================================================
+
+    TrackStore.cpp
+    Created: 21 Oct 2026 2:47:18pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "TrackStore.h"
+
+#include <cstring>
+
+//==============================================================================
+bool TrackStore::Name::operator== (const Name& other) const
+{
+    return length == other.length && (length == 0 || std::memcmp(text, other.text, length) == 0);
+}
+
+TrackStore::TrackStore()
+{
+}
+
+TrackStore::~TrackStore()
+{
+}
+
+int TrackStore::size() const
+{
+    return (int) tracks.size();
+}
+
+bool TrackStore::isEmpty() const
+{
+    return tracks.empty();
+}
+
+void TrackStore::add(const String& path)
+{
+    tracks.push_back(storePath(path.toStdString()));
+    addToTable((int) tracks.size() - 1);
+}
+
+void TrackStore::remove(int index)
+{
+    if (index < 0 || index >= size()) {
+        return;
+    }
+
+    // The names stay in the arena, they are only given back when the store is cleared or rebuilt.
+    // The table is patched rather than rebuilt, so a delete never hashes the other tracks again
+    removeFromTable(index);
+    tracks.erase(tracks.begin() + index);
+    for (auto& slot : table) {
+        if (slot > index + 1) {
+            --slot;
+        }
+    }
+}
+
+void TrackStore::clear()
+{
+    blocks.clear();
+    blockUsed = 0;
+    directories.clear();
+    directoryIndex.clear();
+    tracks.clear();
+    table.clear();
+}
+
+void TrackStore::swapWith(TrackStore& other) noexcept
+{
+    // The arena blocks are swapped as pointers, so every name keeps its place
+    std::swap(blocks, other.blocks);
+    std::swap(blockUsed, other.blockUsed);
+    std::swap(directories, other.directories);
+    std::swap(directoryIndex, other.directoryIndex);
+    std::swap(tracks, other.tracks);
+    std::swap(table, other.table);
+}
+
+String TrackStore::getPath(int index) const
+{
+    if (index < 0 || index >= size()) {
+        return {};
+    }
+
+    const Track& track = tracks[(size_t) index];
+    const char separator = (char) File::getSeparatorChar();
+
+    // Walking up to the root, then writing the folders out from the top
+    std::vector<int> chain;
+    size_t length = track.fileNameLength;
+    for (int directory = track.directory; directory >= 0; directory = directories[(size_t) directory].parent) {
+        chain.push_back(directory);
+        length += directories[(size_t) directory].name.length + 1;
+    }
+
+    std::string path;
+    path.reserve(length);
+    for (auto directory = chain.rbegin(); directory != chain.rend(); ++directory) {
+        const Name& name = directories[(size_t) *directory].name;
+        path.append(name.text, name.length);
+        path += separator;
+    }
+    path.append(track.fileName, track.fileNameLength);
+    return String::fromUTF8(path.data(), (int) path.size());
+}
+
+String TrackStore::getTitle(int index) const
+{
+    if (index < 0 || index >= size()) {
+        return {};
+    }
+
+    const Track& track = tracks[(size_t) index];
+    return String::fromUTF8(track.fileName, (int) track.fileNameLength);
+}
+
+bool TrackStore::contains(const String& path) const
+{
+    return indexOf(path) >= 0;
+}
+
+int TrackStore::indexOf(const String& path) const
+{
+    if (table.empty()) {
+        return -1;
+    }
+
+    // A folder on the path that is not stored means the track is not either
+    const std::string utf8 = path.toStdString();
+    int directory = -1;
+    Name fileName;
+    if (!findPath(utf8, directory, fileName)) {
+        return -1;
+    }
+    return table[findSlot(directory, fileName)] - 1;
+}
+
+TrackStore::Track TrackStore::storePath(const std::string& path)
+{
+    const char separator = (char) File::getSeparatorChar();
+    const size_t last = path.rfind(separator);
+    int directory = -1;
+
+    // Every folder on the path is a node under the one before it, the first is empty for a path from the root
+    if (last != std::string::npos) {
+        for (size_t start = 0;;) {
+            const size_t end = jmin(path.find(separator, start), last);
+            const Name part{ path.data() + start, (uint32) (end - start) };
+
+            auto found = directoryIndex.find({ directory, part });
+            if (found != directoryIndex.end()) {
+                directory = found->second;
+            }
+            else {
+                const Directory node{ directory, storeName(part.text, part.length) };
+                directories.push_back(node);
+                directory = (int) directories.size() - 1;
+                directoryIndex.emplace(DirectoryKey{ node.parent, node.name }, directory);
+            }
+
+            if (end == last) {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    const size_t nameStart = last == std::string::npos ? 0 : last + 1;
+    const Name fileName = storeName(path.data() + nameStart, path.size() - nameStart);
+    return { fileName.text, fileName.length, directory };
+}
+
+bool TrackStore::findPath(const std::string& path, int& directory, Name& fileName) const
+{
+    const char separator = (char) File::getSeparatorChar();
+    const size_t last = path.rfind(separator);
+    directory = -1;
+
+    if (last != std::string::npos) {
+        for (size_t start = 0;;) {
+            const size_t end = jmin(path.find(separator, start), last);
+            auto found = directoryIndex.find({ directory, Name{ path.data() + start, (uint32) (end - start) } });
+            if (found == directoryIndex.end()) {
+                return false;
+            }
+            directory = found->second;
+
+            if (end == last) {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    // The name points into the path, so it is only used while the path is alive
+    const size_t nameStart = last == std::string::npos ? 0 : last + 1;
+    fileName = { path.data() + nameStart, (uint32) (path.size() - nameStart) };
+    return true;
+}
+
+size_t TrackStore::findSlot(int directory, const Name& fileName) const
+{
+    const size_t mask = table.size() - 1;
+    size_t slot = hash(directory, fileName) & mask;
+    while (table[slot] != 0) {
+        const Track& track = tracks[(size_t) table[slot] - 1];
+        if (track.directory == directory && track.getFileName() == fileName) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void TrackStore::addToTable(int index)
+{
+    if (tracks.size() * 2 > table.size()) {
+        rebuildTable();
+        return;
+    }
+
+    // A path that is already stored keeps pointing at its first track
+    const Track& track = tracks[(size_t) index];
+    const size_t slot = findSlot(track.directory, track.getFileName());
+    if (table[slot] == 0) {
+        table[slot] = index + 1;
+    }
+}
+
+void TrackStore::removeFromTable(int index)
+{
+    const Track& track = tracks[(size_t) index];
+    size_t hole = findSlot(track.directory, track.getFileName());
+    if (table[hole] != index + 1) {
+        return;
+    }
+
+    // A later track with the same path takes over the slot
+    for (size_t i = (size_t) index + 1; i < tracks.size(); ++i) {
+        if (tracks[i].directory == track.directory && tracks[i].getFileName() == track.getFileName()) {
+            table[hole] = (int) i + 1;
+            return;
+        }
+    }
+
+    // Otherwise the tracks probed past the slot are shifted back into it, so no lookup stops short at the gap
+    const size_t mask = table.size() - 1;
+    for (size_t next = (hole + 1) & mask; table[next] != 0; next = (next + 1) & mask) {
+        const Track& moved = tracks[(size_t) table[next] - 1];
+        const size_t home = hash(moved.directory, moved.getFileName()) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table[hole] = table[next];
+            hole = next;
+        }
+    }
+    table[hole] = 0;
+}
+
+void TrackStore::rebuildTable()
+{
+    size_t capacity = 64;
+    while (capacity < tracks.size() * 2) {
+        capacity *= 2;
+    }
+    table.assign(capacity, 0);
+
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        const size_t slot = findSlot(tracks[i].directory, tracks[i].getFileName());
+        if (table[slot] == 0) {
+            table[slot] = (int) i + 1;
+        }
+    }
+}
+
+TrackStore::Name TrackStore::storeName(const char* text, size_t length)
+{
+    if (blocks.empty() || blockUsed + length > blockSize) {
+        // A name longer than a block gets a block of its own
+        const size_t size = jmax(blockSize, length);
+        blocks.emplace_back(new char[size]);
+        blockUsed = 0;
+    }
+
+    char* copy = blocks.back().get() + blockUsed;
+    std::memcpy(copy, text, length);
+    blockUsed += length;
+    return { copy, (uint32) length };
+}
+
+size_t TrackStore::hash(int directory, const Name& name)
+{
+    // FNV-1a over the file name, started from the folder
+    uint64 h = 14695981039346656037ull ^ (uint64) (uint32) directory;
+    for (uint32 i = 0; i < name.length; ++i) {
+        h = (h ^ (uint8) name.text[i]) * 1099511628211ull;
+    }
+    return (size_t) h;
+}
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    TrackStore.h
+    Created: 21 Oct 2026 2:47:18pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//==============================================================================
+/*
+    The paths of the tracks in the library, stored compactly.
+
+    Tracks in a library share a handful of folders, so each folder is
+    interned once as a node holding its name and its parent, and a track is
+    only a folder node and its file name. Every name is kept as UTF-8 in an
+    arena of large blocks that never move, and a track's title is the file
+    name in the arena rather than a copy of it. Paths are put back together
+    when they are asked for.
+
+    Looking a path up goes through an open addressing table of track
+    indices, so checking for duplicates does not build any strings.
+*/
+class TrackStore
+{
+public:
+    TrackStore();
+    ~TrackStore();
+
+    int size() const;
+    bool isEmpty() const;
+
+    /** add a track to the end of the store */
+    void add(const String& path);
+
+    /** remove a track, the ones after it move up */
+    void remove(int index);
+
+    void clear();
+    void swapWith(TrackStore& other) noexcept;
+
+    /** get the full path of a track, put back together from its folder and file name */
+    String getPath(int index) const;
+
+    /** get the title shown for a track, which is its file name */
+    String getTitle(int index) const;
+
+    bool contains(const String& path) const;
+
+    /** get the index of the first track with this path, or -1 */
+    int indexOf(const String& path) const;
+
+private:
+    struct Name
+    {
+        const char* text = nullptr;
+        uint32 length = 0;
+
+        bool operator== (const Name& other) const;
+    };
+
+    struct Directory
+    {
+        int parent = -1;
+        Name name;
+    };
+
+    // The file name is kept inline rather than as a Name so a track packs into 16 bytes
+    struct Track
+    {
+        const char* fileName = nullptr;
+        uint32 fileNameLength = 0;
+        int directory = -1;
+
+        Name getFileName() const { return { fileName, fileNameLength }; }
+    };
+
+    // A folder is found by its parent and its name
+    struct DirectoryKey
+    {
+        int parent;
+        Name name;
+
+        bool operator== (const DirectoryKey& other) const { return parent == other.parent && name == other.name; }
+    };
+
+    struct DirectoryKeyHash
+    {
+        size_t operator() (const DirectoryKey& key) const { return hash(key.parent, key.name); }
+    };
+
+    // Function to split a path into its folder and file name, adding the folders and copying the name into the arena
+    Track storePath(const std::string& path);
+
+    // Function to split a path the same way without storing anything, false when a folder on it is not stored
+    bool findPath(const std::string& path, int& directory, Name& fileName) const;
+
+    // Function to find the slot of a track in the table, or the empty slot it would go in
+    size_t findSlot(int directory, const Name& fileName) const;
+
+    // Function to put a track's index in the table, growing the table when it is half full
+    void addToTable(int index);
+    void rebuildTable();
+
+    // Function to take a track's index out of the table before the track is erased
+    void removeFromTable(int index);
+
+    // Function to copy text into the arena and get the copy, which stays in the same place until the store is cleared
+    Name storeName(const char* text, size_t length);
+
+    static size_t hash(int directory, const Name& name);
+
+    static constexpr size_t blockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockUsed = 0;
+
+    std::vector<Directory> directories;
+    std::unordered_map<DirectoryKey, int, DirectoryKeyHash> directoryIndex;
+
+    std::vector<Track> tracks;
+
+    // Slots hold a track index plus one, 0 is empty
+    std::vector<int> table;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackStore)
+};
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Created: 20 Oct 2026 2:26:48pm
+    Author:  Qixuan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Hands the latest value from one writer thread to one reader thread
+    without either of them ever waiting.
+
+    There are three copies of the value: one the writer fills, one the reader
+    looks at, and one in the middle holding the latest published value. The
+    writer publishes by swapping its copy with the middle one, and the reader
+    takes the middle copy when a newer one has been published since it last
+    looked. Neither side can see the other half way through a write, and the
+    writer never blocks however slowly the reader runs.
+*/
+template <typename Type>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    /** get the copy to fill on the writer thread before publishing it */
+    Type& getWriteBuffer() noexcept
+    {
+        return buffers[writeIndex];
+    }
+
+    /** make the filled copy the latest one, called on the writer thread */
+    void publish() noexcept
+    {
+        writeIndex = middle.exchange(writeIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    /** get the latest published copy on the reader thread, which stays the same until read is called again */
+    const Type& read() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshFlag) != 0) {
+            readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        }
+        return buffers[readIndex];
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshFlag = 4;
+
+    Type buffers[3]{};
+    std::atomic<int> middle{ 1 };
+    int writeIndex = 0;
+    int readIndex = 2;
+
+    JUCE_DECLARE_NON_COPYABLE (TripleBuffer)
+};
@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "WaveformDisplay.h"
+#include "Tracer.h"
 
 //==============================================================================
 WaveformDisplay::WaveformDisplay(AudioFormatManager& formatManagerToUse,
@@ -31,6 +32,8 @@ WaveformDisplay::~WaveformDisplay()
 
 void WaveformDisplay::paint (juce::Graphics& g)
 {
+    TraceSpan span("WaveformDisplay::paint");
+
     /* This demo code just fills the component's background and
        draws some placeholder text to get you started.
 
@@ -53,13 +56,28 @@ void WaveformDisplay::paint (juce::Graphics& g)
             0,
             1.0f
         );
+        // Marking the hot cues
+        g.setColour(Colours::yellow);
+        double length = audioThumb.getTotalLength();
+        for (double cue : cuePositions) {
+            if (length > 0) {
+                float x = (float) (cue / length * getWidth());
+                g.drawLine(x, 0.0f, x, (float) getHeight(), 1.5f);
+            }
+        }
+
         g.setColour(Colours::lightgreen);
-        g.drawRect(position * getWidth(), 0, getWidth() / 80, getHeight());
+        g.drawRect(getPlayheadBounds());
+
+        if (slipPosition >= 0) {
+            g.setColour(Colours::cyan);
+            g.fillRect(getSlipBounds());
+        }
     }
     else
     {
         g.setFont(20.0f);
-        g.drawText("File not loaded...", getLocalBounds(),
+        g.drawText(streaming ? "Streaming, no waveform" : "File not loaded...", getLocalBounds(),
             Justification::centred, true);   // draw some placeholder text
     }
 }
@@ -73,7 +91,19 @@ void WaveformDisplay::resized()
 
 void WaveformDisplay::loadURL(URL audioURL)
 {
+    TraceSpan span("WaveformDisplay::loadURL");
+    thumbnailStartTicks = Tracer::isEnabled() ? Time::getHighResolutionTicks() : 0;
+
     audioThumb.clear();
+
+    // A stream is only downloaded once, by the deck, so no waveform is drawn for it
+    streaming = !audioURL.isLocalFile();
+    if (streaming) {
+        fileLoaded = false;
+        repaint();
+        return;
+    }
+
     fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
     if (fileLoaded)
     {
@@ -89,6 +119,12 @@ void WaveformDisplay::loadURL(URL audioURL)
 void WaveformDisplay::changeListenerCallback(ChangeBroadcaster* source)
 {
     std::cout << "wfd: change received! " << std::endl;
+
+    // The thumbnail is built on the cache's thread, so its span runs from loadURL until it is complete
+    if (thumbnailStartTicks != 0 && audioThumb.isFullyLoaded()) {
+        Tracer::record("AudioThumbnail build", thumbnailStartTicks, Time::getHighResolutionTicks());
+        thumbnailStartTicks = 0;
+    }
     repaint();
 }
 
@@ -96,7 +132,46 @@ void WaveformDisplay::setPositionRelative(double pos)
 {
     if (pos != position)
     {
+        // Only the old and new playhead are repainted, and only when the playhead has moved a pixel
+        const Rectangle<int> oldBounds = getPlayheadBounds();
         position = pos;
-        repaint();
+        const Rectangle<int> newBounds = getPlayheadBounds();
+        if (newBounds != oldBounds) {
+            repaint(oldBounds);
+            repaint(newBounds);
+        }
     }
+}
+
+Rectangle<int> WaveformDisplay::getPlayheadBounds() const
+{
+    return { (int) (position * getWidth()), 0, getWidth() / 80, getHeight() };
+}
+
+void WaveformDisplay::setSlipPositionRelative(double pos)
+{
+    if (pos != slipPosition)
+    {
+        const Rectangle<int> oldBounds = getSlipBounds();
+        slipPosition = pos;
+        const Rectangle<int> newBounds = getSlipBounds();
+        if (newBounds != oldBounds) {
+            repaint(oldBounds);
+            repaint(newBounds);
+        }
+    }
+}
+
+Rectangle<int> WaveformDisplay::getSlipBounds() const
+{
+    if (slipPosition < 0) {
+        return {};
+    }
+    return { (int) (slipPosition * getWidth()) - 1, 0, 2, getHeight() };
+}
+
+void WaveformDisplay::setCuePositions(const Array<double>& positions)
+{
+    cuePositions = positions;
+    repaint();
 }
\ No newline at end of file
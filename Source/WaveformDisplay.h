@@ -33,11 +33,30 @@ public:
     /** set the relative position of the playhead*/
     void setPositionRelative(double pos);
 
+    /** set the relative position of the shadow playhead in slip mode, negative hides it */
+    void setSlipPositionRelative(double pos);
+
+    /** set the hot cue positions in seconds to mark on the waveform */
+    void setCuePositions(const Array<double>& positions);
+
 private:
+    // Function to get the area the playhead is drawn in
+    Rectangle<int> getPlayheadBounds() const;
+
+    // Function to get the area the shadow playhead is drawn in, empty when it is hidden
+    Rectangle<int> getSlipBounds() const;
 
     AudioThumbnail audioThumb;
     bool fileLoaded;
+
+    // True when the track is streamed, which has no waveform
+    bool streaming = false;
+
+    // When the thumbnail started building, for the trace
+    int64 thumbnailStartTicks = 0;
     double position;
+    double slipPosition = -1.0;
+    Array<double> cuePositions;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
 };
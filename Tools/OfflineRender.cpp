@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    OfflineRender.cpp
+    Created: 19 Oct 2026 10:18:54pm
+    Author:  Qixuan
+
+    Renders a timeline of deck actions to a WAV or FLAC file without an audio
+    device, and prints how many times faster than real time it went.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+
+#include <iostream>
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    ArgumentList args(argc, argv);
+
+    if (args.size() < 2 || args.containsOption("--help|-h")) {
+        std::cout << "OtoDecksRender timeline.json output.wav [--threads 4] [--segment-seconds 60]\n"
+                     "  --threads          render segments of the mix in parallel on this many threads\n"
+                     "  --segment-seconds  length of each segment when rendering in parallel\n";
+        return args.containsOption("--help|-h") ? 0 : 1;
+    }
+
+    const File timelineFile = args[0].resolveAsFile();
+    const File outputFile = args[1].resolveAsFile();
+    const int numThreads = args.containsOption("--threads") ? args.getValueForOption("--threads").getIntValue() : 1;
+    const double segmentSeconds = args.containsOption("--segment-seconds")
+                                      ? args.getValueForOption("--segment-seconds").getDoubleValue() : 60.0;
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    OfflineRenderer renderer(formatManager);
+
+    Result result = renderer.loadTimeline(timelineFile);
+    if (result.wasOk()) {
+        result = renderer.render(outputFile, numThreads, segmentSeconds);
+    }
+
+    if (result.failed()) {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Rendered " << outputFile.getFullPathName() << " at "
+              << String(renderer.getSpeedUp(), 1) << "x real time" << std::endl;
+    return 0;
+}